@@ -1,5 +1,9 @@
 
-#include "external/glad.h"
+#ifdef WINX_GL_LOADER
+#	include <winx_gl.h>
+#else
+#	include "external/glad.h"
+#endif
 #include <winx.h>
 #include <stdio.h>
 #include "render.h"
@@ -20,8 +24,10 @@ int main() {
 		exit(1);
 	}
 
-	// use GLAD to load OpenGL functions
+	// use GLAD to load OpenGL functions, the built-in loader needs no setup
+#ifndef WINX_GL_LOADER
 	gladLoadGL();
+#endif
 
 	// init OpenGL example
 	init();
@@ -0,0 +1,114 @@
+
+// unit tests for the C++20 coroutines of winx.hpp, run against the null backend so that no window system is needed
+
+#include <winx.hpp>
+#include <cstdio>
+
+#define CHECK(condition) if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); failures ++; }
+
+static int failures = 0;
+static int frames = 0;
+static int steps = 0;
+static bool nested = false;
+
+static winx::task child() {
+	co_await winx::next_frame();
+	nested = true;
+}
+
+static winx::task render() {
+	for (frames = 0; frames < 3; frames ++) {
+
+		// the input coroutine is waiting by now, so the event isn't dropped
+		if (frames == 1) {
+			WinxNullEvent key = {WINX_NULL_KEYBOARD, WINX_PRESSED, WXK_ESC};
+			winxNullPushEvent(&key);
+		}
+
+		co_await winx::next_frame();
+	}
+
+	// a nested task runs to completion before the outer one continues
+	co_await child();
+	CHECK(nested);
+}
+
+static winx::task input() {
+	winx::event event = co_await winx::next_event();
+	CHECK(event.type == winx::event_type::keyboard);
+	CHECK(event.state == WINX_PRESSED && event.code == WXK_ESC);
+	steps ++;
+
+	// nothing else is pushed, so this one times out
+	const double start = winxGetTime();
+	std::optional<winx::event> timeout = co_await winx::next_event(0.5);
+	CHECK(!timeout.has_value());
+	CHECK(winxGetTime() - start >= 0.5 - 1e-9);
+	steps ++;
+}
+
+static winx::task sleeper() {
+	const double start = winxGetTime();
+	co_await winx::sleep(0.25);
+	CHECK(winxGetTime() - start >= 0.25 - 1e-9);
+	steps ++;
+
+	// sleeping for nothing doesn't suspend at all
+	co_await winx::sleep(0);
+	steps ++;
+}
+
+static winx::task stopper() {
+	co_await winx::next_frame();
+	winx::stop();
+	co_await winx::next_frame();
+	steps ++;
+}
+
+static void testRun() {
+	CHECK(winxOpen(320, 240, "coroutines"));
+	winxNullSetSwapInterval(0.01);
+
+	winx::spawn(render());
+	winx::spawn(input());
+	winx::spawn(sleeper());
+
+	// returns once all of them finished
+	winx::run();
+	CHECK(frames == 3 && nested);
+	CHECK(steps == 4);
+	CHECK(winxNullGetSwapCount() == 4);
+	CHECK(winxGetTime() >= 0.5);
+
+	winxClose();
+}
+
+static void testStop() {
+	CHECK(winxOpen(320, 240, "stop"));
+	steps = 0;
+
+	// the stopped coroutine stays suspended and continues with the next run
+	winx::spawn(stopper());
+	winx::run();
+	CHECK(steps == 0);
+	CHECK(winxNullGetSwapCount() == 1);
+
+	winx::run();
+	CHECK(steps == 1);
+	CHECK(winxNullGetSwapCount() == 2);
+
+	winxClose();
+}
+
+int main() {
+	testRun();
+	testStop();
+
+	if (failures) {
+		fprintf(stderr, "%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+	return 0;
+}
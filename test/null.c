@@ -0,0 +1,168 @@
+
+// unit tests for the event loop, run against the null backend so that no window system is needed
+
+#include <winx.h>
+
+#define CHECK(condition) if (!(condition)) { fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); failures ++; }
+
+static int failures = 0;
+static int key_state, key_code, width, height, closes, ticks;
+
+static void onKeyboard(int state, int keycode) {
+	key_state = state;
+	key_code = keycode;
+}
+
+static void onResize(int w, int h) {
+	width = w;
+	height = h;
+}
+
+static void onClose() {
+	closes ++;
+}
+
+static void onTick(int timer) {
+	// stop the lazy loop after the third tick
+	if (++ ticks == 3) {
+		winxRequestRedraw();
+	}
+}
+
+static bool isNear(double a, double b) {
+	return a - b < 1e-9 && b - a < 1e-9;
+}
+
+static void testEvents() {
+	CHECK(winxOpen(320, 240, "events"));
+	winxSetKeyboardEventHandle(onKeyboard);
+	winxSetResizeEventHandle(onResize);
+	winxSetCloseEventHandle(onClose);
+
+	WinxNullEvent key = {WINX_NULL_KEYBOARD, WINX_PRESSED, WXK_SPACE};
+	WinxNullEvent resize = {WINX_NULL_RESIZE, 0, 0, 0, 0, 640, 480};
+	WinxNullEvent close = {WINX_NULL_CLOSE};
+
+	winxNullPushEvent(&key);
+	winxNullPushEvent(&resize);
+	winxNullPushEvent(&close);
+
+	// the events are only dispatched by the next poll
+	CHECK(key_code == 0 && width == 0 && closes == 0);
+	winxPollEvents();
+	CHECK(key_state == WINX_PRESSED && key_code == WXK_SPACE);
+	CHECK(width == 640 && height == 480);
+	CHECK(closes == 1);
+
+	CHECK(winxGetRedraw());
+	winxSwapBuffers();
+	CHECK(!winxGetRedraw());
+
+	// the queue is empty now
+	winxPollEvents();
+	CHECK(closes == 1);
+
+	winxClose();
+}
+
+static void testSwaps() {
+	CHECK(winxOpen(320, 240, "swaps"));
+	CHECK(isNear(winxGetTime(), 0));
+
+	winxNullSetSwapInterval(0.01);
+
+	for (int i = 0; i < 10; i ++) {
+		winxSwapBuffers();
+	}
+
+	CHECK(winxNullGetSwapCount() == 10);
+	CHECK(isNear(winxGetTime(), 0.1));
+
+	winxNullAdvanceTime(1);
+	CHECK(isNear(winxGetTime(), 1.1));
+
+	winxClose();
+}
+
+static void testTimers() {
+	winxHint(WINX_HINT_LAZY, 1);
+	CHECK(winxOpen(320, 240, "timers"));
+	winxNullSetSwapInterval(0);
+
+	CHECK(winxAddTimer(0, onTick) == 0);
+	CHECK(winxAddTimer(1, NULL) == 0);
+
+	const int timer = winxAddTimer(0.25, onTick);
+	CHECK(timer != 0);
+
+	// the window starts out needing a redraw, so the first poll doesn't wait
+	winxPollEvents();
+	CHECK(ticks == 0);
+
+	// a lazy poll skips the fake time ahead from timer to timer until one of them requests a redraw
+	winxSwapBuffers();
+	winxPollEvents();
+	CHECK(ticks == 3);
+	CHECK(isNear(winxGetTime(), 0.75));
+
+	// without timers there is nothing to wait for, so the poll returns right away
+	winxRemoveTimer(timer);
+	winxSwapBuffers();
+	winxPollEvents();
+	CHECK(ticks == 3);
+
+	winxClose();
+	winxHint(WINX_HINT_LAZY, 0);
+}
+
+static void testOpenClose() {
+	unsigned char icon[4 * 4 * 4] = {0};
+
+	// everything created while a window is open is released by winxClose(), run with a leak checker to see it
+	for (int i = 0; i < 100; i ++) {
+		winxHint(WINX_HINT_CONTEXT, i % 2 ? WINX_CONTEXT_SOFTWARE : WINX_CONTEXT_OPENGL);
+		CHECK(winxOpen(64, 64, "cycle"));
+
+		WinxCursor* kept = winxCreateCursorIcon(4, 4, icon, 0, 0);
+		WinxCursor* deleted = winxCreateNullCursorIcon();
+		CHECK(kept && deleted);
+
+		winxSetCursorIcon(kept);
+		winxDeleteCursorIcon(deleted);
+		winxAddTimer(1, onTick);
+
+		if (i % 2) {
+			WinxNullEvent resize = {WINX_NULL_RESIZE, 0, 0, 0, 0, 128, 32};
+			winxNullPushEvent(&resize);
+			winxPollEvents();
+
+			// the pixel buffer follows the window size
+			unsigned int* pixels = winxGetPixels();
+			CHECK(pixels != NULL);
+
+			if (pixels) {
+				pixels[128 * 32 - 1] = 0xFFFFFFFF;
+			}
+		}
+
+		winxSwapBuffers();
+		winxClose();
+	}
+
+	winxHint(WINX_HINT_CONTEXT, WINX_CONTEXT_OPENGL);
+}
+
+int main() {
+	testEvents();
+	testSwaps();
+	testTimers();
+	testOpenClose();
+
+	if (failures) {
+		fprintf(stderr, "%d checks failed\n", failures);
+		return 1;
+	}
+
+	printf("all checks passed\n");
+	return 0;
+}
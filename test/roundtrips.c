@@ -0,0 +1,110 @@
+
+// checks that a frame (winxPollEvents(), the window state getters and winxSwapBuffers()) makes no synchronous round trips
+// to the X server, needs a running X server, the CMake test starts one with xvfb-run
+
+#define _GNU_SOURCE
+#include <winx.h>
+#include <X11/Xlib.h>
+#include <GL/gl.h>
+#include <stdint.h>
+#include <dlfcn.h>
+
+#define FRAMES 100
+
+// Xlib waits for every reply in libxcb, so replacing these counts all round trips, also the ones Xlib makes internally
+typedef struct {
+	unsigned int sequence;
+} WinxVoidCookie;
+
+static int replies = 0;
+
+void* xcb_wait_for_reply(void* connection, unsigned int request, void** error) {
+	static void* (*next)(void*, unsigned int, void**);
+	if (!next) next = (void* (*)(void*, unsigned int, void**)) dlsym(RTLD_NEXT, "xcb_wait_for_reply");
+
+	replies ++;
+	return next(connection, request, error);
+}
+
+void* xcb_wait_for_reply64(void* connection, uint64_t request, void** error) {
+	static void* (*next)(void*, uint64_t, void**);
+	if (!next) next = (void* (*)(void*, uint64_t, void**)) dlsym(RTLD_NEXT, "xcb_wait_for_reply64");
+
+	replies ++;
+	return next(connection, request, error);
+}
+
+void* xcb_request_check(void* connection, WinxVoidCookie cookie) {
+	static void* (*next)(void*, WinxVoidCookie);
+	if (!next) next = (void* (*)(void*, WinxVoidCookie)) dlsym(RTLD_NEXT, "xcb_request_check");
+
+	replies ++;
+	return next(connection, cookie);
+}
+
+static bool testFrames(int context, const char* name) {
+	winxHint(WINX_HINT_CONTEXT, context);
+
+	if (!winxOpen(320, 240, name)) {
+		fprintf(stderr, "%s: %s\n", name, winxGetError());
+		return false;
+	}
+
+	Display* display = (Display*) winxGetNativeDisplay();
+
+	// let the window get mapped and configured first, that part is allowed to wait for the server
+	for (int i = 0; i < 10; i ++) {
+		winxPollEvents();
+		winxSwapBuffers();
+	}
+
+	XSync(display, false);
+
+	const int before = replies;
+	const unsigned long first = XNextRequest(display);
+
+	for (int i = 0; i < FRAMES; i ++) {
+
+		// moving the pointer makes the server send motion events, so that the frames also process some events
+		winxSetCursorPos(i % 100, 100 - i % 100);
+		winxPollEvents();
+
+		// the getters are called every frame, so they have to answer from the state winx already has
+		int width, height, x, y;
+		winxGetWindowSize(&width, &height);
+		winxGetWindowPos(&x, &y);
+		const bool active = winxGetFocus() || winxGetMapped() || winxGetVisible();
+
+		if (context == WINX_CONTEXT_SOFTWARE) {
+			winxGetPixels()[i] = active ? 0xFFFFFFFF : 0xFF000000;
+		}
+
+		if (context == WINX_CONTEXT_OPENGL) {
+			glClearColor(x / (float) width, y / (float) height, active, 1);
+			glClear(GL_COLOR_BUFFER_BIT);
+		}
+
+		winxSwapBuffers();
+	}
+
+	const int count = replies - before;
+	const unsigned long requests = XNextRequest(display) - first;
+
+	// only reported, as events (like the MIT-SHM completions) also tell which requests the server has processed
+	const bool confirmed = LastKnownRequestProcessed(display) >= first;
+
+	winxClose();
+
+	printf("%s: %d round trips and %lu requests in %d frames%s\n", name, count, requests, FRAMES, confirmed ? " (some already confirmed)" : "");
+	return count == 0;
+}
+
+int main() {
+	bool passed = true;
+
+	passed &= testFrames(WINX_CONTEXT_SOFTWARE, "software");
+	passed &= testFrames(WINX_CONTEXT_NONE, "none");
+	passed &= testFrames(WINX_CONTEXT_OPENGL, "opengl");
+
+	return passed ? 0 : 1;
+}
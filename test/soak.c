@@ -0,0 +1,143 @@
+
+// opens and closes the window over and over again, with cursors, icons and timers created in each cycle, and fails if
+// the resident memory or (on X11 with the XRes extension) the number of X resources keeps growing, build with
+// WINX_SANITIZE to also let LeakSanitizer check every allocation, usage: winx-soak [cycles] [software|opengl]
+
+#include <winx.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(WINX_SOAK_XRES)
+#	include <X11/Xlib.h>
+#	include <X11/extensions/XRes.h>
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#	define WINX_SOAK_ASAN
+#elif defined(__has_feature)
+#	if __has_feature(address_sanitizer)
+#		define WINX_SOAK_ASAN
+#	endif
+#endif
+
+// allowed growth of the resident memory between the end of the warm up and the last cycle
+#define WINX_SOAK_RSS_LIMIT (2 * 1024 * 1024)
+
+static void onTimer(int timer) {}
+
+static long getResidentBytes() {
+	long pages = 0, resident = 0;
+	FILE* file = fopen("/proc/self/statm", "r");
+
+	if (file) {
+		if (fscanf(file, "%ld %ld", &pages, &resident) != 2) {
+			resident = 0;
+		}
+
+		fclose(file);
+	}
+
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+// number of resources (windows, pixmaps, cursors, ...) the server holds for this client, -1 if unknown
+static long getResourceCount() {
+	long count = -1;
+
+#if defined(WINX_SOAK_XRES)
+	Display* display = (Display*) winxGetNativeDisplay();
+	int event_base, error_base, type_count = 0;
+	XResType* types = NULL;
+
+	// any resource of the client identifies it, so use the window
+	if (display && XResQueryExtension(display, &event_base, &error_base)) {
+		if (XResQueryClientResources(display, (XID) (uintptr_t) winxGetNativeWindow(), &type_count, &types)) {
+			count = 0;
+
+			for (int i = 0; i < type_count; i ++) {
+				count += types[i].count;
+			}
+
+			XFree(types);
+		}
+	}
+#endif
+
+	return count;
+}
+
+int main(int argc, char** argv) {
+	const int cycles = argc > 1 ? atoi(argv[1]) : 500;
+	const int warmup = cycles / 10;
+	const bool software = argc > 2 && strcmp(argv[2], "software") == 0;
+
+	unsigned char image[16 * 16 * 4];
+	memset(image, 0xFF, sizeof(image));
+
+	// keep the display connection between the cycles, so that X resources leaked by one window pile up
+	winxHint(WINX_HINT_CONTEXT, software ? WINX_CONTEXT_SOFTWARE : WINX_CONTEXT_OPENGL);
+	winxHint(WINX_HINT_PERSISTENT, WINX_PERSISTENT_DISPLAY);
+
+	long warm_bytes = 0, warm_resources = -1;
+	long bytes = 0, resources = -1;
+
+	for (int i = 0; i < cycles; i ++) {
+		if (!winxOpen(200, 100, "soak")) {
+			fprintf(stderr, "cycle %d: %s\n", i, winxGetError());
+			return 1;
+		}
+
+		// the cursors that are not deleted here are deleted by winxClose()
+		WinxCursor* kept = winxCreateCursorIcon(16, 16, image, 8, 8);
+		WinxCursor* deleted = winxCreateCursorIcon(16, 16, image, 0, 0);
+		winxCreateNullCursorIcon();
+
+		winxSetIcon(16, 16, image);
+		winxSetCursorIcon(deleted);
+		winxSetCursorIcon(kept);
+		winxDeleteCursorIcon(deleted);
+		winxAddTimer(1, onTimer);
+
+		for (int frame = 0; frame < 3; frame ++) {
+			winxPollEvents();
+			winxSwapBuffers();
+		}
+
+		resources = getResourceCount();
+		winxClose();
+
+		bytes = getResidentBytes();
+
+		if (i == warmup) {
+			warm_bytes = bytes;
+			warm_resources = resources;
+		}
+	}
+
+	winxTerminate();
+
+	const long growth = bytes - warm_bytes;
+	bool passed = true;
+
+	printf("%d cycles, resident memory grew by %ld bytes after the first %d\n", cycles, growth, warmup);
+
+	// AddressSanitizer keeps freed memory in quarantine, there LeakSanitizer checks for leaks instead
+#if !defined(WINX_SOAK_ASAN)
+	if (growth > WINX_SOAK_RSS_LIMIT) {
+		fprintf(stderr, "resident memory kept growing\n");
+		passed = false;
+	}
+#endif
+
+	if (resources != -1) {
+		printf("X resources: %ld after the first %d cycles, %ld in the last one\n", warm_resources, warmup, resources);
+
+		if (resources > warm_resources) {
+			fprintf(stderr, "X resources kept growing\n");
+			passed = false;
+		}
+	}
+
+	return passed ? 0 : 1;
+}
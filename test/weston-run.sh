@@ -0,0 +1,34 @@
+#!/bin/sh
+# runs the given command against a headless weston compositor, like xvfb-run does for X11, usage: weston-run.sh command [args...]
+
+WESTON=${WESTON:-weston}
+SOCKET=winx-test-$$
+
+# the compositor needs a runtime directory, which is not set in most CI environments
+if [ -z "$XDG_RUNTIME_DIR" ]; then
+	XDG_RUNTIME_DIR=$(mktemp -d)
+	chmod 700 "$XDG_RUNTIME_DIR"
+	export XDG_RUNTIME_DIR
+fi
+
+"$WESTON" --backend=headless-backend.so --socket="$SOCKET" --idle-time=0 &
+PID=$!
+
+# wait up to ten seconds for the compositor to create its socket
+for i in $(seq 100); do
+	[ -S "$XDG_RUNTIME_DIR/$SOCKET" ] && break
+	sleep 0.1
+done
+
+if [ ! -S "$XDG_RUNTIME_DIR/$SOCKET" ]; then
+	echo "weston-run.sh: weston did not start" >&2
+	kill $PID 2> /dev/null
+	exit 1
+fi
+
+WAYLAND_DISPLAY=$SOCKET "$@"
+STATUS=$?
+
+kill $PID
+wait $PID 2> /dev/null
+exit $STATUS
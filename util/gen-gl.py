@@ -0,0 +1,184 @@
+#!/bin/env python3
+
+# Generates the optional WINX OpenGL loader (winx_gl.h and winx_gl.c) from the Khronos gl.xml registry
+# usage: gen-gl.py <gl.xml> <output directory> <version> <core|compatibility> [extension...]
+
+import sys
+import os
+import xml.etree.ElementTree as xml
+
+if len(sys.argv) < 5:
+	print("Usage: gen-gl.py <gl.xml> <output directory> <version> <core|compatibility> [extension...]")
+	exit(1)
+
+registry = xml.parse(sys.argv[1]).getroot()
+output = sys.argv[2]
+version = tuple(int(part) for part in sys.argv[3].split("."))
+profile = sys.argv[4]
+extensions = [name for name in sys.argv[5:] if name]
+
+# these are defined as empty macros by windef.h
+reserved = ["near", "far"]
+
+def is_gl(element):
+	return element.get("api", "gl") == "gl"
+
+def is_selected(element):
+	return is_gl(element) and element.get("profile", profile) == profile
+
+def flatten(element, rename = None):
+	text = element.text or ""
+
+	for child in element:
+		if child.tag == "apientry":
+			text += "APIENTRY"
+		elif child.tag == "name" and rename:
+			text += rename(child.text)
+		else:
+			text += flatten(child)
+
+		text += child.tail or ""
+
+	return text
+
+def safe_name(name):
+	return name + "_" if name in reserved else name
+
+# collect everything the registry defines
+types = [flatten(element) for element in registry.findall("types/type") if is_gl(element)]
+enums = {}
+commands = {}
+
+for element in registry.findall("enums/enum"):
+	if is_gl(element) and not element.get("name") in enums:
+		enums[element.get("name")] = element.get("value")
+
+for element in registry.findall("commands/command"):
+	proto = element.find("proto")
+	name = proto.find("name").text
+
+	params = [element for element in element.findall("param") if is_gl(element)]
+
+	commands[name] = {
+		"result": flatten(proto, lambda name: "").strip(),
+		"params": [flatten(param, safe_name).strip() for param in params],
+		"names": [safe_name(param.find("name").text) for param in params]
+	}
+
+# select the parts needed by the requested version and extensions
+required_enums = []
+required_commands = []
+core_commands = []
+
+def require(element, core):
+	for name in [entry.get("name") for entry in element.findall("enum")]:
+		if not name in required_enums:
+			required_enums.append(name)
+
+	for name in [entry.get("name") for entry in element.findall("command")]:
+		if not name in required_commands:
+			required_commands.append(name)
+
+		if core and not name in core_commands:
+			core_commands.append(name)
+
+def remove(element):
+	for name in [entry.get("name") for entry in element.findall("enum")]:
+		if name in required_enums:
+			required_enums.remove(name)
+
+	for name in [entry.get("name") for entry in element.findall("command")]:
+		if name in required_commands:
+			required_commands.remove(name)
+
+		if name in core_commands:
+			core_commands.remove(name)
+
+for feature in registry.findall("feature"):
+	number = tuple(int(part) for part in feature.get("number").split("."))
+
+	if feature.get("api") != "gl" or number > version:
+		continue
+
+	for element in feature.findall("require"):
+		if is_selected(element):
+			require(element, True)
+
+	for element in feature.findall("remove"):
+		if is_selected(element):
+			remove(element)
+
+for extension in extensions:
+	element = registry.find(f"extensions/extension[@name='{extension}']")
+
+	if element is None or not "gl" in element.get("supported").split("|"):
+		print(f"Unknown extension '{extension}'!")
+		exit(1)
+
+	for element in element.findall("require"):
+		if is_selected(element):
+			require(element, False)
+
+# write the header
+with open(os.path.join(output, "winx_gl.h"), "w") as header:
+	header.write("\n// generated by util/gen-gl.py, do not edit\n")
+	header.write(f"// OpenGL {sys.argv[3]} {profile}" + "".join(f", {name}" for name in extensions) + "\n\n")
+	header.write("#ifndef WINX_GL_H\n#define WINX_GL_H\n\n")
+	header.write("#if defined(__gl_h_) || defined(__GL_H__)\n#	error \"winx_gl.h needs to be included before other OpenGL headers\"\n#endif\n\n")
+	header.write("#define __gl_h_\n#define __GL_H__\n#define __gl_glext_h_\n#define __glext_h_\n\n")
+	header.write("#include <stdbool.h>\n\n")
+	header.write("#ifndef APIENTRY\n#	if defined(_WIN32)\n#		define APIENTRY __stdcall\n#	else\n#		define APIENTRY\n#	endif\n#endif\n\n")
+	header.write("#ifndef APIENTRYP\n#	define APIENTRYP APIENTRY *\n#endif\n\n")
+	header.write("#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n")
+
+	for text in types:
+		header.write(text + "\n")
+
+	header.write("\n")
+
+	for name in required_enums:
+		header.write(f"#define {name} {enums[name]}\n")
+
+	header.write("\n")
+
+	for name in required_commands:
+		command = commands[name]
+		params = ", ".join(command["params"]) or "void"
+
+		header.write(f"typedef {command['result']} (APIENTRYP PFN{name.upper()}PROC) ({params});\n")
+		header.write(f"extern PFN{name.upper()}PROC winx_{name};\n")
+		header.write(f"#define {name} winx_{name}\n")
+
+	header.write("\n/// resolve all OpenGL functions right away, instead of on their first call\n")
+	header.write("/// returns false if some of the core functions are missing, called by winxOpen() with WINX_LOADER_BATCH\n")
+	header.write("bool winxLoadGLFunctions(void);\n\n")
+	header.write("#ifdef __cplusplus\n}\n#endif\n\n#endif // WINX_GL_H\n")
+
+# write the source, each function starts as a stub that resolves the real function on its first call
+with open(os.path.join(output, "winx_gl.c"), "w") as source:
+	source.write("\n// generated by util/gen-gl.py, do not edit\n\n")
+	source.write("#include \"winx_gl.h\"\n#include <winx.h>\n\n")
+
+	for name in required_commands:
+		command = commands[name]
+		params = ", ".join(command["params"]) or "void"
+		arguments = ", ".join(command["names"])
+		result = "" if command["result"] == "void" else "return "
+
+		source.write(f"static {command['result']} APIENTRY winx_lazy_{name}({params}) {{\n")
+		source.write(f"\twinx_{name} = (PFN{name.upper()}PROC) winxGetProcAddress(\"{name}\");\n")
+		source.write(f"\t{result}winx_{name}({arguments});\n")
+		source.write("}\n\n")
+		source.write(f"PFN{name.upper()}PROC winx_{name} = winx_lazy_{name};\n\n")
+
+	source.write("bool winxLoadGLFunctions(void) {\n\tbool success = true;\n\n")
+
+	for name in required_commands:
+		source.write(f"\twinx_{name} = (PFN{name.upper()}PROC) winxGetProcAddress(\"{name}\");\n")
+
+		if name in core_commands:
+			source.write(f"\tsuccess = success && winx_{name};\n")
+
+	source.write("\n\treturn success;\n}\n")
+
+print(f"Generated {len(required_commands)} functions and {len(required_enums)} enums")
@@ -4,6 +4,16 @@
 #define SET_HINT(HINT_ENUM, HINT_VAR) case HINT_ENUM: HINT_VAR = value; break;
 #define WINX_CONTEXT_ASSERT(function) if(!winx) { winxErrorMsg = (char*) (function ": No active winx context!"); return; }
 
+// the redraw flag is cleared by winxSwapBuffers() on the render thread and set by the event thread
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#	define WINX_SET_REDRAW(value) _InterlockedExchange(&winx->redraw, (value))
+#	define WINX_GET_REDRAW() (_InterlockedOr(&winx->redraw, 0) != 0)
+#else
+#	define WINX_SET_REDRAW(value) __atomic_store_n(&winx->redraw, (value), __ATOMIC_RELAXED)
+#	define WINX_GET_REDRAW() (__atomic_load_n(&winx->redraw, __ATOMIC_RELAXED) != 0)
+#endif
+
 // dummy functions
 void WinxDummyCursorEventHandle(int x, int y) {}
 void WinxDummyButtonEventHandle(int type, int button) {}
@@ -12,6 +22,11 @@ void WinxDummyScrollEventHandle(int scroll) {}
 void WinxDummyCloseEventHandle() {}
 void WinxDummyResizeEventHandle(int width, int height) {}
 void WinxDummyFocusEventHandle(bool focus) {}
+void WinxDummyExposeEventHandle(int x, int y, int width, int height) {}
+void WinxDummyMonitorEventHandle(int monitor) {}
+void WinxDummyVisibilityEventHandle(bool visible) {}
+void WinxDummyDebugEventHandle(const WinxDebugMessage* message) {}
+bool WinxDummyNativeEventHandle(void* event) { return false; }
 
 // hints
 static int __winx_hint_vsync = 0;
@@ -27,10 +42,56 @@ static int __winx_hint_opengl_core = 1;
 static int __winx_hint_opengl_debug = 0;
 static int __winx_hint_opengl_robust = 0;
 static int __winx_hint_multisamples = 0;
+static int __winx_hint_context = WINX_CONTEXT_OPENGL;
+static int __winx_hint_lazy = 0;
+static int __winx_hint_persistent = WINX_PERSISTENT_NONE;
+static int __winx_hint_opengl_loader = WINX_LOADER_LAZY;
+static int __winx_hint_throttle = 0;
+static int __winx_hint_opengl_no_error = 0;
+static int __winx_hint_opengl_release = WINX_RELEASE_FLUSH;
+static int __winx_hint_srgb = 0;
+static int __winx_hint_input_samples = 0;
 
 // current error message
 static char* winxErrorMsg = NULL;
 
+// implemented in the common OpenGL section, called after the context is created,
+// just before presenting a frame, and before the context is destroyed respectively
+static void winxInitGL();
+static void winxEndFrame();
+static void winxFreeGL();
+
+// implemented in the common OpenGL section, checks if a space separated extension list
+// (like the GLX, EGL and legacy OpenGL ones) contains the exact given name
+static bool winxHasToken(const char* list, const char* name);
+
+// implemented by each platform, called after event handles change
+static void winxUpdateEventMask();
+
+// implemented in the common section, called after the visibility state changes,
+// and at the start of each swap (returns true if the frame should not be presented)
+static void winxUpdateVisibility();
+static bool winxThrottleFrame();
+
+// implemented in the common section, the time until the next timer is due (-1 without timers), calls the handles of
+// due timers and ready descriptors at the end of each event processing, and removes all of them when the window closes
+static double winxGetTimerWait();
+static void winxDispatchSources();
+static void winxFreeSources();
+
+// implemented in the common section, cursor icons are deleted together with the window, so they are kept in a list,
+// the first adds a new icon, the second removes it (returns false if it was already deleted), and the last one
+// releases the pointer and deletes all icons that are still alive when the window closes
+static void winxTrackCursor(WinxCursor* cursor);
+static bool winxUntrackCursor(WinxCursor* cursor);
+static void winxFreeCursors();
+
+#if defined(WINX_GLX) || defined(WINX_WAYLAND)
+// implemented in the common section, waits for the display connection (if not -1), the watched descriptors
+// or the next timer, whichever comes first (returns true if the connection is readable)
+static bool winxPollSources(int connection, int timeout);
+#endif
+
 char* winxGetError() {
 	char* copy = winxErrorMsg;
 	winxErrorMsg = NULL;
@@ -53,46 +114,220 @@ void winxHint(int hint, int value) {
 		SET_HINT(WINX_HINT_OPENGL_DEBUG, __winx_hint_opengl_debug);
 		SET_HINT(WINX_HINT_OPENGL_ROBUST, __winx_hint_opengl_robust);
 		SET_HINT(WINX_HINT_MULTISAMPLES, __winx_hint_multisamples);
+		SET_HINT(WINX_HINT_CONTEXT, __winx_hint_context);
+		SET_HINT(WINX_HINT_LAZY, __winx_hint_lazy);
+		SET_HINT(WINX_HINT_PERSISTENT, __winx_hint_persistent);
+		SET_HINT(WINX_HINT_OPENGL_LOADER, __winx_hint_opengl_loader);
+		SET_HINT(WINX_HINT_THROTTLE, __winx_hint_throttle);
+		SET_HINT(WINX_HINT_OPENGL_NO_ERROR, __winx_hint_opengl_no_error);
+		SET_HINT(WINX_HINT_OPENGL_RELEASE, __winx_hint_opengl_release);
+		SET_HINT(WINX_HINT_SRGB, __winx_hint_srgb);
+		SET_HINT(WINX_HINT_INPUT_SAMPLES, __winx_hint_input_samples);
 	}
 }
 
 #undef SET_HINT
 
+#if !defined(WINX_NULL)
+// clip a {x, y, width, height} rectangle to the given area, returns false if nothing is left
+static bool winxClipRect(const int* rect, int width, int height, int* clipped) {
+	int x1 = rect[0] < 0 ? 0 : rect[0];
+	int y1 = rect[1] < 0 ? 0 : rect[1];
+	int x2 = rect[0] + rect[2] > width ? width : rect[0] + rect[2];
+	int y2 = rect[1] + rect[3] > height ? height : rect[1] + rect[3];
+
+	clipped[0] = x1;
+	clipped[1] = y1;
+	clipped[2] = x2 - x1;
+	clipped[3] = y2 - y1;
+
+	return x2 > x1 && y2 > y1;
+}
+#endif
+
 // begin winx GLX implementation
 #if defined(WINX_GLX)
 
 #include <X11/Xlib.h>
+#include <X11/XKBlib.h>
+#include <X11/Xatom.h>
+#if defined(WINX_XCB)
+#	include <X11/Xlib-xcb.h>
+#	include <xcb/xcb.h>
+#endif
 #include <X11/keysym.h>
 #include <X11/Xcursor/Xcursor.h>
+#include <X11/extensions/XShm.h>
+#include <X11/extensions/Xrandr.h>
+#include <X11/extensions/XInput2.h>
 #include <GL/glx.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <string.h>
+#include <poll.h>
 #include <time.h>
+#include <dlfcn.h>
 
 // copied from glxext.h
 typedef int (*PFNGLXSWAPINTERVALMESAPROC) (unsigned int interval);
 typedef void (*PFNGLXSWAPINTERVALEXTPROC) (Display *dpy, GLXDrawable drawable, int interval);
 typedef GLXContext (*PFNGLXCREATECONTEXTATTRIBSARBPROC) (Display *dpy, GLXFBConfig config, GLXContext share_context, Bool direct, const int *attrib_list);
+typedef void (*PFNGLXCOPYSUBBUFFERMESAPROC) (Display *dpy, GLXDrawable drawable, int x, int y, int width, int height);
+
+#ifndef GLX_ARB_create_context_no_error
+#	define GLX_CONTEXT_OPENGL_NO_ERROR_ARB 0x31B3
+#endif
+
+#ifndef GLX_ARB_context_flush_control
+#	define GLX_CONTEXT_RELEASE_BEHAVIOR_ARB 0x2097
+#	define GLX_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB 0
+#endif
+
+#ifndef GLX_ARB_framebuffer_sRGB
+#	define GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB 0x20B2
+#endif
 
 static PFNGLXSWAPINTERVALMESAPROC glXSwapIntervalMESA;
 static PFNGLXSWAPINTERVALEXTPROC glXSwapIntervalEXT;
 static PFNGLXCREATECONTEXTATTRIBSARBPROC glXCreateContextAttribsARB;
+static PFNGLXCOPYSUBBUFFERMESAPROC glXCopySubBufferMESA;
+
+// copied from vulkan_core.h, vulkan_xlib.h and vulkan_xcb.h
+typedef void (*PFNVKVOIDFUNCTIONPROC) (void);
+typedef PFNVKVOIDFUNCTIONPROC (*PFNVKGETINSTANCEPROCADDRPROC) (void* instance, const char* name);
+
+typedef struct {
+	int sType;
+	const void* pNext;
+	unsigned int flags;
+	Display* dpy;
+	Window window;
+} VkXlibSurfaceCreateInfoKHR;
+
+#if defined(WINX_XCB)
+typedef struct {
+	int sType;
+	const void* pNext;
+	unsigned int flags;
+	xcb_connection_t* connection;
+	xcb_window_t window;
+} VkXcbSurfaceCreateInfoKHR;
+#endif
+
+typedef int (*PFNVKCREATEXLIBSURFACEKHRPROC) (void* instance, const VkXlibSurfaceCreateInfoKHR* info, const void* allocator, void* surface);
+#if defined(WINX_XCB)
+typedef int (*PFNVKCREATEXCBSURFACEKHRPROC) (void* instance, const VkXcbSurfaceCreateInfoKHR* info, const void* allocator, void* surface);
+#endif
+
+#define VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR 1000004000
+#define VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR 1000005000
+
+static PFNVKGETINSTANCEPROCADDRPROC vkGetInstanceProcAddr;
 
 // winx cursor image struct
 struct WinxCursor_s {
 	Cursor native;
+	WinxCursor* next;
 };
 
+// software frame buffer struct
+typedef struct {
+	XImage* image;
+	XShmSegmentInfo segment;
+	bool busy;
+} WinxFrameBuffer;
+
+// XInput2 pointer device with the valuators needed for the input samples
+typedef struct {
+	int id;
+	bool touch;
+	int valuators[3]; // pressure, tilt x and tilt y valuator numbers, -1 if the device doesn't have them
+	double min[3];
+	double max[3];
+	double value[3]; // events only contain the valuators that changed
+} WinxInputDevice;
+
+// number of hints in the list returned by winxGetPersistentHints(), the display only depends on the first few
+#define WINX_PERSISTENT_HINTS 17
+#define WINX_PERSISTENT_DISPLAY_HINTS 9
+
 // winx global state struct
 typedef struct {
 	Display* display;
 	Window window;
 	GLXContext context;
+	GLXFBConfig config;
+	XVisualInfo info;
+	Colormap colormap;
+	bool no_error;
+	bool release_none;
+	bool srgb;
+	bool copy_sub_buffer;
+	int persistent;
+	int hints[WINX_PERSISTENT_HINTS];
 	Atom wm_delete_window;
 	Atom net_wm_icon;
+	Atom net_wm_state;
+	Atom net_wm_state_fullscreen;
+	Atom net_wm_state_hidden;
+	Atom net_wm_bypass_compositor;
 	Atom cardinal;
-
+	Atom abs_pressure;
+	Atom abs_tilt_x;
+	Atom abs_tilt_y;
+	Atom abs_mt_pressure;
+
+	int mode;
+	GC gc;
+	Visual* visual;
+	bool shm;
+	int shm_completion;
+	int buffer;
+	WinxFrameBuffer buffers[2];
+
+	KeySym keysyms[256];
+	bool keys[256];
+	bool detectable_repeat;
+
+	int xi_opcode;
+	int xi_minor;
+	int device_count;
+	WinxInputDevice* devices;
+	int sample_count;
+	int sample_capacity;
+	WinxInputSample* samples;
+
+	int randr_event;
+	int monitor;
+	int monitor_count;
+	WinxMonitor* monitors;
+
+	int x;
+	int y;
+	int width;
+	int height;
+	bool reparented;
+	bool focused;
+	bool mapped;
+	bool obscured;
+	bool hidden;
+	bool visible;
 	bool capture;
+	bool lazy;
+	long redraw;
+	int throttle;
+	double throttle_time;
+	long event_mask;
+
+#if defined(WINX_XCB)
+	xcb_connection_t* connection;
+	xcb_get_property_cookie_t state_cookie;
+	bool state_pending;
+#endif
+
 	time_t time;
 	WinxCursor* cursor_icon;
+	WinxCursor* cursors;
 	WinxCursorEventHandle cursor;
 	WinxButtonEventHandle button;
 	WinxKeyboardEventHandle keyboard;
@@ -100,10 +335,18 @@ typedef struct {
 	WinxCloseEventHandle close;
 	WinxResizeEventHandle resize;
 	WinxFocusEventHandle focus;
+	WinxExposeEventHandle expose;
+	WinxMonitorEventHandle monitor_change;
+	WinxVisibilityEventHandle visibility;
+	WinxNativeEventHandle native;
+	bool native_after;
 } WinxHandle;
 
 static WinxHandle* winx = NULL;
 
+// state kept alive after winxClose() with the WINX_HINT_PERSISTENT hint set
+static WinxHandle* winxPersistent = NULL;
+
 static __GLXextFuncPtr winxGetProc(const char* name) {
 	if (winxErrorMsg == NULL) {
 		__GLXextFuncPtr proc = glXGetProcAddress((const unsigned char*) name);
@@ -118,588 +361,3710 @@ static __GLXextFuncPtr winxGetProc(const char* name) {
 	return NULL;
 }
 
-static void winxUpdateCursorState(bool captured, WinxCursor* cursor) {
-	if (captured) {
-		unsigned int events = ButtonPressMask | ButtonReleaseMask | PointerMotionMask;
-		XGrabPointer(winx->display, winx->window, true, events, GrabModeAsync, GrabModeAsync, winx->window, None, CurrentTime);
-	} else {
-		XUngrabPointer(winx->display, CurrentTime);
-	}
+static bool winxShmError = false;
 
-	if (cursor) {
-		XDefineCursor(winx->display, winx->window, cursor->native);
-	} else {
-		XUndefineCursor(winx->display, winx->window);
-	}
+static int winxShmErrorHandler(Display* display, XErrorEvent* event) {
+	winxShmError = true;
+	return 0;
 }
 
-bool winxOpen(int width, int height, const char* title) {
-	winx = (WinxHandle*) calloc(1, sizeof(WinxHandle));
-	winx->capture = false;
+static bool winxContextError = false;
 
-	struct timespec spec;
-	clock_gettime(CLOCK_REALTIME, &spec);
-	winx->time = spec.tv_sec;
+static int winxContextErrorHandler(Display* display, XErrorEvent* event) {
+	winxContextError = true;
+	return 0;
+}
 
-	// set dummy function pointers
-	winxResetEventHandles();
+static bool winxHasGLXExtension(const char* extension) {
+	return winxHasToken(glXQueryExtensionsString(winx->display, DefaultScreen(winx->display)), extension);
+}
 
-	// get display handle
-	winx->display = XOpenDisplay(NULL);
-	if (!winx->display) {
-		winxErrorMsg = (char*) "XOpenDisplay: Failed to acquire display handle!";
-		return false;
-	}
+static Bool winxIsShmCompletion(Display* display, XEvent* event, XPointer arg) {
+	return event->type == winx->shm_completion && ((XShmCompletionEvent*) event)->shmseg == ((WinxFrameBuffer*) arg)->segment.shmseg;
+}
 
-	// GLX attributes
-	int attributes[] = {
-		GLX_RENDER_TYPE, GLX_RGBA_BIT,
-		GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
-		GLX_DOUBLEBUFFER, true,
-		GLX_RED_SIZE, __winx_hint_red_bits,
-		GLX_GREEN_SIZE, __winx_hint_green_bits,
-		GLX_BLUE_SIZE, __winx_hint_blue_bits,
-		GLX_DEPTH_SIZE, __winx_hint_depth_bits,
-		GLX_STENCIL_SIZE, __winx_hint_stencil_bits,
-		GLX_SAMPLE_BUFFERS, __winx_hint_multisamples ? 1 : 0,
-		GLX_SAMPLES, __winx_hint_multisamples,
-		None
-	};
+static bool winxCreateFrameBuffer(WinxFrameBuffer* buffer, int width, int height) {
+	memset(buffer, 0, sizeof(WinxFrameBuffer));
 
-	int screen = DefaultScreen(winx->display);
-	Window root = RootWindow(winx->display, screen);
+	if (winx->shm) {
+		buffer->image = XShmCreateImage(winx->display, winx->visual, 24, ZPixmap, NULL, &buffer->segment, width, height);
+		buffer->segment.shmid = buffer->image ? shmget(IPC_PRIVATE, buffer->image->bytes_per_line * buffer->image->height, IPC_CREAT | 0600) : -1;
 
-	// find frame buffer config matching our attributes
-	int count;
-	GLXFBConfig *fbconfigs = glXChooseFBConfig(winx->display, screen, attributes, &count);
-	if (!fbconfigs || !count) {
-		winxErrorMsg = (char*) "glXChooseFBConfig: Failed to choose a frame buffer config!";
-		return false;
-	}
+		if (buffer->segment.shmid != -1) {
+			buffer->segment.shmaddr = buffer->image->data = (char*) shmat(buffer->segment.shmid, 0, 0);
+			buffer->segment.readOnly = false;
 
-	// find visual based on framebuffer's config
-	XVisualInfo* info = glXGetVisualFromFBConfig(winx->display, fbconfigs[0]);
-	if (!info) {
-		winxErrorMsg = (char*) "glXGetVisualFromFBConfig: Failed to choose a visual!";
-		return false;
-	}
+			// MIT-SHM can be advertised but still be unusable (for example over a forwarded connection)
+			// so catch the error instead of letting the default handler terminate the application
+			winxShmError = buffer->segment.shmaddr == (char*) -1;
 
-	// set X11 window attributes
-	XSetWindowAttributes x11_attributes;
-	x11_attributes.background_pixel = 0;
-	x11_attributes.border_pixel = 0;
-	x11_attributes.colormap = XCreateColormap(winx->display, root, info->visual, AllocNone);
+			if (!winxShmError) {
+				XErrorHandler handler = XSetErrorHandler(winxShmErrorHandler);
+				XShmAttach(winx->display, &buffer->segment);
+				XSync(winx->display, false);
+				XSetErrorHandler(handler);
+			}
 
-	x11_attributes.event_mask =
-		StructureNotifyMask | ExposureMask | PointerMotionMask | KeyPressMask | KeyReleaseMask | ButtonPressMask | ButtonReleaseMask | FocusChangeMask;
+			// the segment will be freed once both we and the server detach from it
+			shmctl(buffer->segment.shmid, IPC_RMID, 0);
 
-	unsigned long mask = CWBackPixel | CWBorderPixel | CWColormap | CWEventMask;
+			if (!winxShmError) {
+				return true;
+			}
 
-	// finally create X11 window
-	winx->window = XCreateWindow(winx->display, root, 0, 0, width, height, 0, info->depth, InputOutput, info->visual, mask, &x11_attributes);
+			if (buffer->segment.shmaddr != (char*) -1) {
+				shmdt(buffer->segment.shmaddr);
+			}
 
-	// set name
-	winxSetTitle(title);
+			buffer->segment.shmaddr = NULL;
+		}
 
-	// show X11 window
-	XMapWindow(winx->display, winx->window);
+		if (buffer->image) {
+			buffer->image->data = NULL;
+			XDestroyImage(buffer->image);
+		}
 
-	// create GLX context
-	GLXContext context = glXCreateContext(winx->display, info, NULL, 1);
-	if (!context) {
-		winxErrorMsg = (char*) "glXCreateContext: Failed to create GLX context!";
-		return false;
+		// fall back to plain XPutImage
+		winx->shm = false;
 	}
 
-	glXMakeCurrent(winx->display, winx->window, context);
-
-	glXCreateContextAttribsARB = (PFNGLXCREATECONTEXTATTRIBSARBPROC) winxGetProc("glXCreateContextAttribsARB");
-	glXSwapIntervalEXT = (PFNGLXSWAPINTERVALEXTPROC) glXGetProcAddress((const unsigned char*) "glXSwapIntervalEXT"); // optional
-	glXSwapIntervalMESA = (PFNGLXSWAPINTERVALMESAPROC) glXGetProcAddress((const unsigned char*) "glXSwapIntervalMESA"); // optional
+	char* data = (char*) calloc(width * height, 4);
+	buffer->image = XCreateImage(winx->display, winx->visual, 24, ZPixmap, 0, data, width, height, 32, 0);
 
-	if (winxErrorMsg != NULL) {
+	if (!buffer->image) {
+		free(data);
+		winxErrorMsg = (char*) "XCreateImage: Failed to create frame buffer!";
 		return false;
 	}
 
-	glXMakeCurrent(winx->display, 0, 0);
-	glXDestroyContext(winx->display, context);
-
-	XFree(info);
-
-	int flags = 0;
+	return true;
+}
 
-	if (__winx_hint_opengl_debug) flags |= GLX_CONTEXT_DEBUG_BIT_ARB;
-	if (__winx_hint_opengl_robust) flags |= GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB;
+static void winxWaitFrameBuffer(WinxFrameBuffer* buffer) {
+	if (buffer->busy) {
+		XEvent event;
+		XIfEvent(winx->display, &event, winxIsShmCompletion, (XPointer) buffer);
+		buffer->busy = false;
+	}
+}
 
-	int context_attributes[] = {
-		GLX_CONTEXT_MAJOR_VERSION_ARB, __winx_hint_opengl_major,
-		GLX_CONTEXT_MINOR_VERSION_ARB, __winx_hint_opengl_minor,
-		GLX_CONTEXT_PROFILE_MASK_ARB, __winx_hint_opengl_core ? GLX_CONTEXT_CORE_PROFILE_BIT_ARB : GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
-		GLX_CONTEXT_FLAGS_ARB, flags,
-		None
-	};
+static void winxDeleteFrameBuffer(WinxFrameBuffer* buffer) {
+	if (!buffer->image) {
+		return;
+	}
 
-	winx->context = glXCreateContextAttribsARB(winx->display, fbconfigs[0], NULL, true, context_attributes);
-	if (!winx->context) {
-		winxErrorMsg = (char*) "glXCreateContextAttribsARB: Failed to create context";
-		return false;
+	if (buffer->segment.shmaddr) {
+		winxWaitFrameBuffer(buffer);
+		XShmDetach(winx->display, &buffer->segment);
+		shmdt(buffer->segment.shmaddr);
+		buffer->image->data = NULL;
 	}
 
-	glXMakeCurrent(winx->display, winx->window, winx->context);
+	XDestroyImage(buffer->image);
+	buffer->image = NULL;
+}
 
-	// needed for window icon
-	winx->net_wm_icon = XInternAtom(winx->display, "_NET_WM_ICON", false);
-    winx->cardinal = XInternAtom(winx->display, "CARDINAL", false);
+static bool winxCreateFrameBuffers(int width, int height) {
+	winx->buffer = 0;
 
-	// needed to handle the close button
-	winx->wm_delete_window = XInternAtom(winx->display, "WM_DELETE_WINDOW", false);
-	XSetWMProtocols(winx->display, winx->window, &(winx->wm_delete_window), 1);
+	// without MIT-SHM XPutImage copies the pixels right away so one buffer is enough
+	for (int i = 0; i < 2; i ++) {
+		if (!winxCreateFrameBuffer(&winx->buffers[i], width, height)) {
+			return false;
+		}
 
-	// set vsync
-	winxSetVsync(__winx_hint_vsync);
+		if (!winx->shm) {
+			break;
+		}
+	}
 
 	return true;
 }
 
-void winxPollEvents() {
-	while (XPending(winx->display) > 0) {
+static void winxDeleteFrameBuffers() {
+	winxDeleteFrameBuffer(&winx->buffers[0]);
+	winxDeleteFrameBuffer(&winx->buffers[1]);
+}
 
-		XEvent event;
-		XNextEvent(winx->display, &event);
+// build the keycode to keysym table, so that key events don't need to look it up each time,
+// this matches what XLookupKeysym() does for the first keysym of each keycode
+static void winxUpdateKeysyms() {
+	int min_keycode, max_keycode, keysyms_per_keycode;
+	XDisplayKeycodes(winx->display, &min_keycode, &max_keycode);
 
-		switch (event.type) {
+	KeySym* mapping = XGetKeyboardMapping(winx->display, min_keycode, max_keycode - min_keycode + 1, &keysyms_per_keycode);
+	memset(winx->keysyms, 0, sizeof(winx->keysyms));
 
-			case ClientMessage:
-				if ((Atom) event.xclient.data.l[0] == winx->wm_delete_window) {
-					winx->close();
-					break;
-				}
-				break;
+	if (!mapping) {
+		return;
+	}
 
-			case KeyPress:
-				winx->keyboard(WINX_PRESSED, XLookupKeysym(&event.xkey, 0));
-				break;
+	for (int keycode = min_keycode; keycode <= max_keycode; keycode ++) {
+		KeySym* keysyms = mapping + (keycode - min_keycode) * keysyms_per_keycode;
+		KeySym lower, upper;
 
-			case KeyRelease:
-				winx->keyboard(WINX_RELEASED, XLookupKeysym(&event.xkey, 0));
-				break;
+		// if only one keysym is listed it stands for both cases
+		if (keysyms_per_keycode == 1 || keysyms[1] == NoSymbol) {
+			XConvertCase(keysyms[0], &lower, &upper);
+			winx->keysyms[keycode] = lower;
+			continue;
+		}
 
-			case ButtonPress:
-				if (event.xbutton.button == Button4) {
-					winx->scroll(1);
-					break;
-				}
+		winx->keysyms[keycode] = keysyms[0];
+	}
 
-				if (event.xbutton.button == Button5) {
-					winx->scroll(-1);
-					break;
-				}
+	XFree(mapping);
+}
 
-				winx->button(WINX_PRESSED, event.xbutton.button);
-				break;
+// intern all the given atoms with a single round trip
+static void winxInternAtoms(const char** names, Atom** atoms, int count) {
+#if defined(WINX_XCB)
+	xcb_intern_atom_cookie_t cookies[16];
 
-			case ButtonRelease:
-				winx->button(WINX_RELEASED, event.xbutton.button);
-				break;
+	// send all requests first, and only then wait for the replies
+	for (int i = 0; i < count; i ++) {
+		cookies[i] = xcb_intern_atom(winx->connection, 0, strlen(names[i]), names[i]);
+	}
 
-			case MotionNotify:
-				winx->cursor(event.xmotion.x, event.xmotion.y);
-				break;
+	for (int i = 0; i < count; i ++) {
+		xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(winx->connection, cookies[i], NULL);
+		*atoms[i] = reply ? reply->atom : None;
+		free(reply);
+	}
+#else
+	Atom values[16];
+	XInternAtoms(winx->display, (char**) names, count, false, values);
 
-			case ConfigureNotify:
-				winx->resize(event.xconfigure.width, event.xconfigure.height);
-				break;
+	for (int i = 0; i < count; i ++) {
+		*atoms[i] = values[i];
+	}
+#endif
+}
 
-			case FocusIn:
-				winx->focus(true);
-				winxUpdateCursorState(winx->capture, winx->cursor_icon);
-				break;
+// check if the window manager marked the window as hidden (for example minimized), with XCB only the request
+// is sent here and the reply is read by winxReceiveStateHidden() once all queued events were processed
+static void winxRequestStateHidden() {
+#if defined(WINX_XCB)
+	if (!winx->state_pending) {
+		winx->state_cookie = xcb_get_property(winx->connection, 0, winx->window, winx->net_wm_state, XCB_ATOM_ATOM, 0, 1024);
+		winx->state_pending = true;
+	}
+#else
+	Atom type;
+	int format;
+	unsigned long count, remaining;
+	Atom* atoms = NULL;
+
+	XGetWindowProperty(winx->display, winx->window, winx->net_wm_state, 0, 1024, false, XA_ATOM, &type, &format, &count, &remaining, (unsigned char**) &atoms);
+	winx->hidden = false;
+
+	for (unsigned long i = 0; atoms && i < count; i ++) {
+		if (atoms[i] == winx->net_wm_state_hidden) {
+			winx->hidden = true;
+		}
+	}
 
-			case FocusOut:
-				winx->focus(false);
-				winxUpdateCursorState(false, NULL);
-				break;
+	XFree(atoms);
+	winxUpdateVisibility();
+#endif
+}
 
-			default:
-				break;
+static void winxReceiveStateHidden() {
+#if defined(WINX_XCB)
+	if (!winx->state_pending) {
+		return;
+	}
+
+	xcb_get_property_reply_t* reply = xcb_get_property_reply(winx->connection, winx->state_cookie, NULL);
+	winx->state_pending = false;
+	winx->hidden = false;
+
+	if (reply) {
+		const xcb_atom_t* atoms = (const xcb_atom_t*) xcb_get_property_value(reply);
+		const int count = xcb_get_property_value_length(reply) / sizeof(xcb_atom_t);
 
+		for (int i = 0; i < count; i ++) {
+			if (atoms[i] == winx->net_wm_state_hidden) {
+				winx->hidden = true;
+			}
 		}
 
+		free(reply);
 	}
-}
 
-void winxSwapBuffers() {
-	glXSwapBuffers(winx->display, winx->window);
+	winxUpdateVisibility();
+#endif
 }
 
-void winxClose() {
-	glXDestroyContext(winx->display, winx->context);
-	XDestroyWindow(winx->display, winx->window);
-	XCloseDisplay(winx->display);
+// find the pens and touch screens, and select the XInput2 events for them,
+// called again when devices are added or removed
+static void winxUpdateInputDevices() {
+	int count = 0;
+	XIDeviceInfo* devices = XIQueryDevice(winx->display, XIAllDevices, &count);
 
-	free(winx);
-	winx = NULL;
-}
+	free(winx->devices);
+	winx->devices = (WinxInputDevice*) calloc(count, sizeof(WinxInputDevice));
+	winx->device_count = 0;
 
-void winxSetTitle(const char* title) {
-	WINX_CONTEXT_ASSERT("winxSetTitle");
+	for (int i = 0; i < count; i ++) {
+		if (devices[i].use != XISlavePointer) {
+			continue;
+		}
 
-	XStoreName(winx->display, winx->window, title);
-	XSetIconName(winx->display, winx->window, title);
-}
+		WinxInputDevice* device = winx->devices + winx->device_count;
+		device->id = devices[i].deviceid;
+		device->touch = false;
 
-void winxSetIcon(int width, int height, unsigned char* buffer) {
-	WINX_CONTEXT_ASSERT("winxSetIcon");
+		for (int j = 0; j < 3; j ++) {
+			device->valuators[j] = -1;
+		}
 
-	// We need to convert RGBA byte array to a suported format
-	// X11 expects the icon in format [[long: width] [long: height] [long: bgra]...]...
+		for (int j = 0; j < devices[i].num_classes; j ++) {
+			XIAnyClassInfo* info = devices[i].classes[j];
 
-	const int size = width * height;
-	unsigned long* icon = (unsigned long*) malloc(sizeof(long) * (size + 2));
+			if (info->type == XITouchClass) {
+				device->touch = true;
+			}
 
-	icon[0] = width;
-	icon[1] = height;
+			if (info->type == XIValuatorClass) {
+				XIValuatorClassInfo* valuator = (XIValuatorClassInfo*) info;
+				int index = -1;
 
-	for (int i = 0, j = 2; i < size * 4; i += 4) {
-		icon[j ++] = buffer[i + 2] | buffer[i + 1] << 8 | buffer[i + 0] << 16 | buffer[i + 3] << 24;
+				if (valuator->label == winx->abs_pressure || valuator->label == winx->abs_mt_pressure) index = 0;
+				if (valuator->label == winx->abs_tilt_x) index = 1;
+				if (valuator->label == winx->abs_tilt_y) index = 2;
+
+				if (index != -1 && valuator->max > valuator->min) {
+					device->valuators[index] = valuator->number;
+					device->min[index] = valuator->min;
+					device->max[index] = valuator->max;
+					device->value[index] = valuator->value;
+				}
+			}
+		}
+
+		// other pointers (like mice) keep using the core events
+		if (device->touch || device->valuators[0] != -1) {
+			winx->device_count ++;
+		}
 	}
 
-	XChangeProperty(winx->display, winx->window, winx->net_wm_icon, winx->cardinal, 32, PropModeReplace, (const unsigned char*) icon, size + 2);
+	XIFreeDeviceInfo(devices);
 
-	free(icon);
-}
+	// touch events are selected on the master pointer, pen events directly on the pen devices, as selecting
+	// the pointer events on the master would stop the core events that the other event handles depend on
+	unsigned char masks[3 + winx->device_count][XIMaskLen(XI_LASTEVENT)];
+	XIEventMask selection[3 + winx->device_count];
+	int selected = 0;
 
-WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, int x, int y) {
-	if (!winx) {
-		winxErrorMsg = (char*) "winxCreateCursorIcon: No active winx context!";
-		return NULL;
-	}
+	memset(masks, 0, sizeof(masks));
 
-	XcursorImage* image = XcursorImageCreate(width, height);
-	if (!image) {
-		winxErrorMsg = (char*) "XcursorImageCreate: Failed to create cursor image!";
-		return NULL;
-	}
+	selection[selected].deviceid = XIAllDevices;
+	XISetMask(masks[selected], XI_HierarchyChanged);
+	selected ++;
 
-	image->xhot = x;
-	image->yhot = y;
-	XcursorPixel* pixels = image->pixels;
+	if (winx->xi_minor >= 2) {
+		selection[selected].deviceid = XIAllMasterDevices;
+		XISetMask(masks[selected], XI_TouchBegin);
+		XISetMask(masks[selected], XI_TouchUpdate);
+		XISetMask(masks[selected], XI_TouchEnd);
+		selected ++;
+	}
 
-	for (int i = 0, j = 0; i < width * height * 4; i += 4) {
-		pixels[j ++] = buffer[i + 2] | buffer[i + 1] << 8 | buffer[i + 0] << 16 | buffer[i + 3] << 24;
+	for (int i = 0; i < winx->device_count; i ++) {
+		if (!winx->devices[i].touch) {
+			selection[selected].deviceid = winx->devices[i].id;
+			XISetMask(masks[selected], XI_Motion);
+			XISetMask(masks[selected], XI_ButtonPress);
+			XISetMask(masks[selected], XI_ButtonRelease);
+			selected ++;
+		}
 	}
 
-	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
-	cursor->native = XcursorImageLoadCursor(winx->display, image);
-    XcursorImageDestroy(image);
+	for (int i = 0; i < selected; i ++) {
+		selection[i].mask_len = sizeof(masks[i]);
+		selection[i].mask = masks[i];
+	}
 
-	return cursor;
+	XISelectEvents(winx->display, winx->window, selection, selected);
 }
 
-WinxCursor* winxCreateNullCursorIcon() {
-	unsigned char pixels[1 * 1 * 4] = {0, 0, 0, 0};
-	return winxCreateCursorIcon(1, 1, pixels, 0, 0);
-}
+// valuators are only included in the event if they changed, packed in the order of their numbers
+static double winxGetInputValuator(WinxInputDevice* device, const XIValuatorState* state, int index) {
+	const double* value = state->values;
 
-void winxDeleteCursorIcon(WinxCursor* cursor) {
-	if (cursor) {
-		XFreeCursor(winx->display, cursor->native);
-		free(cursor);
+	if (device->valuators[index] == -1) {
+		return 0;
 	}
-}
 
-void winxSetVsync(int vsync) {
-	WINX_CONTEXT_ASSERT("winxSetVsync");
+	for (int i = 0; i < state->mask_len * 8; i ++) {
+		if (XIMaskIsSet(state->mask, i)) {
+			if (i == device->valuators[index]) {
+				device->value[index] = *value;
+				break;
+			}
 
-	if (glXSwapIntervalEXT) {
-		glXSwapIntervalEXT(winx->display, glXGetCurrentDrawable(), __winx_hint_vsync);
-	} else {
-		if (glXSwapIntervalMESA) {
-			glXSwapIntervalMESA(__winx_hint_vsync == WINX_VSYNC_ADAPTIVE ? WINX_VSYNC_ENABLED : __winx_hint_vsync);
+			value ++;
 		}
 	}
+
+	return (device->value[index] - device->min[index]) / (device->max[index] - device->min[index]);
 }
 
-bool winxGetFocus() {
-	if (!winx) {
-		winxErrorMsg = (char*) "winxGetFocus: No active winx context!";
-		return false;
+static void winxPushInputSample(int source, int state, int id, const XIDeviceEvent* event) {
+	WinxInputDevice* device = NULL;
+
+	for (int i = 0; i < winx->device_count; i ++) {
+		if (winx->devices[i].id == event->sourceid) {
+			device = winx->devices + i;
+		}
+	}
+
+	if (!device) {
+		return;
 	}
 
-	Window focused;
-	int state;
+	// keep all samples until the next frame, so that none are lost even at high pen rates
+	if (winx->sample_count == winx->sample_capacity) {
+		winx->sample_capacity = winx->sample_capacity ? winx->sample_capacity * 2 : 64;
+		winx->samples = (WinxInputSample*) realloc(winx->samples, winx->sample_capacity * sizeof(WinxInputSample));
+	}
 
-	XGetInputFocus(winx->display, &focused, &state);
-	return focused == winx->window;
+	WinxInputSample* sample = winx->samples + (winx->sample_count ++);
+	sample->source = source;
+	sample->state = state;
+	sample->id = id;
+	sample->x = event->event_x;
+	sample->y = event->event_y;
+	sample->time = event->time / 1000.0;
+
+	// touches without a pressure valuator are always fully pressed
+	sample->pressure = device->valuators[0] == -1 && source == WINX_SOURCE_TOUCH ? 1.0 : winxGetInputValuator(device, &event->valuators, 0);
+	sample->tilt_x = device->valuators[1] == -1 ? 0 : winxGetInputValuator(device, &event->valuators, 1) * 2 - 1;
+	sample->tilt_y = device->valuators[2] == -1 ? 0 : winxGetInputValuator(device, &event->valuators, 2) * 2 - 1;
 }
 
-void winxSetFocus() {
-	WINX_CONTEXT_ASSERT("winxSetFocus");
+static void winxProcessInputEvent(XGenericEventCookie* cookie) {
+	const XIDeviceEvent* event = (const XIDeviceEvent*) cookie->data;
 
-	XSetInputFocus(winx->display, winx->window, RevertToNone, CurrentTime);
+	switch (cookie->evtype) {
+		case XI_HierarchyChanged:
+			winxUpdateInputDevices();
+			break;
 
-	// this doesn't seem to actually bring the window up
-	// investigate if there is a more reliable solution
-	XRaiseWindow(winx->display, winx->window);
-	XFlush(winx->display);
-}
+		case XI_TouchBegin:
+			winxPushInputSample(WINX_SOURCE_TOUCH, WINX_PRESSED, event->detail, event);
+			break;
 
-void winxSetCursorPos(int x, int y) {
-	WINX_CONTEXT_ASSERT("winxSetCursorPos");
+		case XI_TouchUpdate:
+			winxPushInputSample(WINX_SOURCE_TOUCH, WINX_MOVED, event->detail, event);
+			break;
 
-	XWarpPointer(winx->display, None, winx->window, 0, 0, 0, 0, x, y);
-	XFlush(winx->display);
-}
+		case XI_TouchEnd:
+			winxPushInputSample(WINX_SOURCE_TOUCH, WINX_RELEASED, event->detail, event);
+			break;
 
-double winxGetTime() {
-	if (!winx) {
-		winxErrorMsg = (char*) "winxGetTime: No active winx context!";
-		return 0;
+		case XI_Motion:
+			winxPushInputSample(WINX_SOURCE_PEN, WINX_MOVED, event->sourceid, event);
+			break;
+
+		// only the pen tip, the other buttons still arrive as core button events
+		case XI_ButtonPress:
+		case XI_ButtonRelease:
+			if (event->detail == 1) {
+				winxPushInputSample(WINX_SOURCE_PEN, cookie->evtype == XI_ButtonPress ? WINX_PRESSED : WINX_RELEASED, event->sourceid, event);
+			}
+			break;
 	}
 
+	WINX_SET_REDRAW(true);
+}
+
+static void winxSleep(double seconds) {
 	struct timespec spec;
-	clock_gettime(CLOCK_REALTIME, &spec);
-	return (spec.tv_sec - winx->time) + (spec.tv_nsec / (double) 1e+9);
+	spec.tv_sec = (time_t) seconds;
+	spec.tv_nsec = (long) ((seconds - spec.tv_sec) * 1e+9);
+
+	nanosleep(&spec, NULL);
 }
 
-#endif // GLX
+static void winxUpdateMonitors() {
+	Window root = DefaultRootWindow(winx->display);
+	XRRScreenResources* resources = XRRGetScreenResourcesCurrent(winx->display, root);
+	RROutput primary = XRRGetOutputPrimary(winx->display, root);
 
-#if defined(WINX_WINAPI)
+	free(winx->monitors);
+	winx->monitors = (WinxMonitor*) calloc(resources ? resources->noutput : 0, sizeof(WinxMonitor));
+	winx->monitor_count = 0;
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#include <windowsx.h>
-#include <gl/GL.h>
+	if (!resources) {
+		return;
+	}
 
-// copied from wglext.h
-typedef BOOL(WINAPI * PFNWGLCHOOSEPIXELFORMATARBPROC) (HDC hdc, const int *piAttribIList, const FLOAT *pfAttribFList, UINT nMaxFormats, int *piFormats, UINT *nNumFormats);
-typedef HGLRC(WINAPI * PFNWGLCREATECONTEXTATTRIBSARBPROC) (HDC hDC, HGLRC hShareContext, const int *attribList);
-typedef BOOL(WINAPI * PFNWGLSWAPINTERVALEXTPROC) (int interval);
+	for (int i = 0; i < resources->noutput; i ++) {
+		XRROutputInfo* output = XRRGetOutputInfo(winx->display, resources, resources->outputs[i]);
 
-#define WGL_SAMPLE_BUFFERS_ARB            0x2041
-#define WGL_SAMPLES_ARB                   0x2042
-#define WGL_DRAW_TO_WINDOW_ARB            0x2001
-#define WGL_SUPPORT_OPENGL_ARB            0x2010
-#define WGL_DOUBLE_BUFFER_ARB             0x2011
-#define WGL_PIXEL_TYPE_ARB                0x2013
-#define WGL_TYPE_RGBA_ARB                 0x202B
-#define WGL_ACCELERATION_ARB              0x2003
-#define WGL_FULL_ACCELERATION_ARB         0x2027
-#define WGL_COLOR_BITS_ARB                0x2014
-#define WGL_ALPHA_BITS_ARB                0x201B
-#define WGL_DEPTH_BITS_ARB                0x2022
-#define WGL_CONTEXT_MAJOR_VERSION_ARB     0x2091
-#define WGL_CONTEXT_MINOR_VERSION_ARB     0x2092
-#define WGL_CONTEXT_PROFILE_MASK_ARB      0x9126
-#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB  0x00000001
-#define WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB 0x00000002
-#define WGL_SWAP_EXCHANGE_ARB             0x2028
-#define WGL_SWAP_METHOD_ARB               0x2007
-#define WGL_SWAP_COPY_ARB                 0x2029
-#define WGL_CONTEXT_FLAGS_ARB             0x2094
-#define WGL_CONTEXT_DEBUG_BIT_ARB         0x00000001
-#define WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB 0x00000004
-#define WGL_SAMPLE_BUFFERS_ARB            0x2041
-#define WGL_SAMPLES_ARB                   0x2042
-#define WGL_RED_BITS_ARB                  0x2015
-#define WGL_GREEN_BITS_ARB                0x2017
-#define WGL_BLUE_BITS_ARB                 0x2019
-#define WGL_STENCIL_BITS_ARB              0x2023
+		// both can fail if the output or crtc goes away while this runs, which is likely during hotplug
+		if (!output) {
+			continue;
+		}
 
-static PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT;
+		XRRCrtcInfo* crtc = output->connection == RR_Connected && output->crtc ? XRRGetCrtcInfo(winx->display, resources, output->crtc) : NULL;
 
-// winx cursor image struct
-struct WinxCursor_s {
-	HCURSOR native;
-};
+		if (crtc) {
+			WinxMonitor* monitor = winx->monitors + (winx->monitor_count ++);
 
-// winx global state struct
-typedef struct {
-	HWND hndl;
-	HDC device;
-	HGLRC context;
+			snprintf(monitor->name, sizeof(monitor->name), "%.*s", output->nameLen, output->name);
+			monitor->x = crtc->x;
+			monitor->y = crtc->y;
+			monitor->width = crtc->width;
+			monitor->height = crtc->height;
+			monitor->primary = resources->outputs[i] == primary;
 
-	unsigned long long time;
-	bool capture;
-	WinxCursor* cursor_icon;
-	WinxCursorEventHandle cursor;
-	WinxButtonEventHandle button;
-	WinxKeyboardEventHandle keyboard;
-	WinxScrollEventHandle scroll;
-	WinxCloseEventHandle close;
-	WinxResizeEventHandle resize;
-	WinxFocusEventHandle focus;
-} WinxHandle;
+			for (int j = 0; j < resources->nmode; j ++) {
+				const XRRModeInfo* mode = resources->modes + j;
 
-static WinxHandle* winx = NULL;
+				// the real refresh rate is usually not an integer (like 59.951 Hz), so
+				// calculate it from the pixel clock and the total number of pixels scanned
+				if (mode->id == crtc->mode && mode->hTotal && mode->vTotal) {
+					double refresh = (double) mode->dotClock / ((double) mode->hTotal * (double) mode->vTotal);
 
-static PROC winxGetProc(LPCSTR name) {
-	if (winxErrorMsg == NULL) {
-		PROC proc = wglGetProcAddress(name);
+					if (mode->modeFlags & RR_DoubleScan) refresh /= 2;
+					if (mode->modeFlags & RR_Interlace) refresh *= 2;
 
-		if (proc == NULL) {
-			winxErrorMsg = (char*) "wglGetProcAddress: Failed to load function!";
+					monitor->refresh = refresh;
+				}
+			}
+
+			XRRFreeCrtcInfo(crtc);
 		}
 
-		return proc;
+		XRRFreeOutputInfo(output);
 	}
 
-	return NULL;
+	XRRFreeScreenResources(resources);
 }
 
-static void winxUpdateCursorState(bool captured, WinxCursor* cursor) {
-	if (captured) {
-		RECT rect;
+static void winxUpdateWindowMonitor(bool changed) {
+	int center_x = winx->x + winx->width / 2;
+	int center_y = winx->y + winx->height / 2;
+	int index = 0;
 
-		// taken from GLFW
-		GetClientRect(winx->hndl, &rect);
-		ClientToScreen(winx->hndl, (POINT*) &rect.left);
-		ClientToScreen(winx->hndl, (POINT*) &rect.right);
+	for (int i = 0; i < winx->monitor_count; i ++) {
+		const WinxMonitor* monitor = winx->monitors + i;
 
-		bool success = ClipCursor(&rect);
-		if (!success) {
-			winxErrorMsg = (char*) "ClipCursor: Failed to clip cursor!";
+		if (center_x >= monitor->x && center_y >= monitor->y && center_x < monitor->x + monitor->width && center_y < monitor->y + monitor->height) {
+			index = i;
+			break;
 		}
-	} else {
-		ClipCursor(NULL);
 	}
 
-	if (cursor) {
-		SetCursor(cursor->native);
-	} else {
-		SetCursor(LoadCursor(NULL, IDC_ARROW));
+	if (changed || index != winx->monitor) {
+		winx->monitor = index;
+		winx->monitor_change(index);
 	}
 }
 
-static LRESULT CALLBACK winxWndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
-	LRESULT result = 0;
+// only select input events that have a handle, so that the X server doesn't send events that would be ignored anyway,
+// structure, exposure, focus, visibility and property events are always needed by winx itself
+static long winxGetEventMask() {
+	long mask = StructureNotifyMask | ExposureMask | FocusChangeMask | VisibilityChangeMask | PropertyChangeMask;
 
-	switch (message) {
-		case WM_KEYDOWN:
-			winx->keyboard(WINX_PRESSED, wParam);
-			break;
+	if (winx->cursor != WinxDummyCursorEventHandle) {
+		mask |= PointerMotionMask;
+	}
 
-		case WM_KEYUP:
-			winx->keyboard(WINX_RELEASED, wParam);
-			break;
+	if (winx->button != WinxDummyButtonEventHandle || winx->scroll != WinxDummyScrollEventHandle) {
+		mask |= ButtonPressMask | ButtonReleaseMask;
+	}
 
-		case WM_MOUSEMOVE:
-			winx->cursor(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
-			break;
+	if (winx->keyboard != WinxDummyKeyboardEventHandle) {
+		mask |= KeyPressMask | KeyReleaseMask;
+	}
 
-		case WM_LBUTTONDOWN:
-			winx->button(WINX_PRESSED, WXB_LEFT);
-			break;
+	return mask;
+}
 
-		case WM_LBUTTONUP:
-			winx->button(WINX_RELEASED, WXB_LEFT);
-			break;
+static void winxUpdateEventMask() {
+	const long mask = winxGetEventMask();
 
-		case WM_MBUTTONDOWN:
-			winx->button(WINX_PRESSED, WXB_CENTER);
-			break;
+	// the handles are also set before the window is created
+	if (!winx->window || winx->event_mask == mask) {
+		return;
+	}
 
-		case WM_MBUTTONUP:
-			winx->button(WINX_RELEASED, WXB_CENTER);
-			break;
+	XSetWindowAttributes x11_attributes;
+	x11_attributes.event_mask = mask;
+	winx->event_mask = mask;
 
-		case WM_RBUTTONDOWN:
-			winx->button(WINX_PRESSED, WXB_RIGHT);
-			break;
+	XChangeWindowAttributes(winx->display, winx->window, CWEventMask, &x11_attributes);
 
-		case WM_RBUTTONUP:
-			winx->button(WINX_RELEASED, WXB_RIGHT);
-			break;
+	// the pointer grab has its own event mask, this does nothing if the pointer is not grabbed
+	XChangeActivePointerGrab(winx->display, mask & (ButtonPressMask | ButtonReleaseMask | PointerMotionMask), None, CurrentTime);
+}
 
-		case WM_MOUSEWHEEL:
-			winx->scroll(GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA);
-			break;
+static void winxUpdateCursorState(bool captured, WinxCursor* cursor) {
+	if (captured) {
+		unsigned int events = winx->event_mask & (ButtonPressMask | ButtonReleaseMask | PointerMotionMask);
+		XGrabPointer(winx->display, winx->window, true, events, GrabModeAsync, GrabModeAsync, winx->window, None, CurrentTime);
+	} else {
+		XUngrabPointer(winx->display, CurrentTime);
+	}
 
-		case WM_CLOSE:
-			winx->close();
-			break;
+	if (cursor) {
+		XDefineCursor(winx->display, winx->window, cursor->native);
+	} else {
+		XUndefineCursor(winx->display, winx->window);
+	}
+}
 
-		case WM_SIZE:
-			winx->resize(LOWORD(lParam), HIWORD(lParam));
-			break;
+static bool winxCreateContext(GLXFBConfig config, XVisualInfo* info) {
 
-		case WM_SETFOCUS:
-			winx->focus(true);
-			winxUpdateCursorState(winx->capture, winx->cursor_icon);
-			break;
+	// the extension functions are the same for every context, so they only need to be loaded once
+	if (!glXCreateContextAttribsARB) {
 
-		case WM_KILLFOCUS:
-			winx->focus(false);
-			winxUpdateCursorState(false, NULL);
-			break;
+		// create GLX context
+		GLXContext context = glXCreateContext(winx->display, info, NULL, 1);
+		if (!context) {
+			winxErrorMsg = (char*) "glXCreateContext: Failed to create GLX context!";
+			return false;
+		}
 
-		// needed because yes
-		// https://docs.microsoft.com/en-us/windows/win32/learnwin32/setting-the-cursor-image
-		case WM_SETCURSOR:
-			if (LOWORD(lParam) == HTCLIENT) {
-				winxUpdateCursorState(winx->capture, winx->cursor_icon);
-				return TRUE;
-			}
-			break;
+		glXMakeCurrent(winx->display, winx->window, context);
 
-		default:
-			result = DefWindowProcA(hWnd, message, wParam, lParam);
-	}
+		glXCreateContextAttribsARB = (PFNGLXCREATECONTEXTATTRIBSARBPROC) winxGetProc("glXCreateContextAttribsARB");
+		glXSwapIntervalEXT = (PFNGLXSWAPINTERVALEXTPROC) glXGetProcAddress((const unsigned char*) "glXSwapIntervalEXT"); // optional
+		glXSwapIntervalMESA = (PFNGLXSWAPINTERVALMESAPROC) glXGetProcAddress((const unsigned char*) "glXSwapIntervalMESA"); // optional
+		glXCopySubBufferMESA = (PFNGLXCOPYSUBBUFFERMESAPROC) glXGetProcAddress((const unsigned char*) "glXCopySubBufferMESA"); // optional
 
-	return result;
-}
+		glXMakeCurrent(winx->display, 0, 0);
+		glXDestroyContext(winx->display, context);
 
-bool winxOpen(int width, int height, const char* title) {
-	winx = (WinxHandle*) calloc(1, sizeof(WinxHandle));
-	winx->capture = false;
+		if (winxErrorMsg != NULL) {
+			return false;
+		}
 
-	QueryPerformanceCounter((LARGE_INTEGER*) &winx->time);
+	}
 
-	HINSTANCE hinstance = GetModuleHandle(NULL);
+	int flags = 0;
 
-	// set dummy function pointers
-	winxResetEventHandles();
+	if (__winx_hint_opengl_debug) flags |= GLX_CONTEXT_DEBUG_BIT_ARB;
+	if (__winx_hint_opengl_robust) flags |= GLX_CONTEXT_ROBUST_ACCESS_BIT_ARB;
 
-	// register window class
-	const char* clazz = "WinxOpenGLClass";
+	int context_attributes[16] = {
+		GLX_CONTEXT_MAJOR_VERSION_ARB, __winx_hint_opengl_major,
+		GLX_CONTEXT_MINOR_VERSION_ARB, __winx_hint_opengl_minor,
+		GLX_CONTEXT_PROFILE_MASK_ARB, __winx_hint_opengl_core ? GLX_CONTEXT_CORE_PROFILE_BIT_ARB : GLX_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
+		GLX_CONTEXT_FLAGS_ARB, flags,
+		None
+	};
 
-	WNDCLASSEXA wcex = {0};
-	wcex.cbSize = sizeof(WNDCLASSEX);
-	wcex.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW | CS_DBLCLKS;
-	wcex.lpfnWndProc = (WNDPROC) winxWndProc;
-	wcex.cbClsExtra = 0;
-	wcex.cbWndExtra = 0;
-	wcex.hInstance = hinstance;
-	wcex.hIcon = LoadIcon(NULL, IDI_WINLOGO);
-	wcex.hCursor = LoadCursor(NULL, IDC_ARROW);
-	wcex.hbrBackground = NULL;
-	wcex.lpszMenuName = NULL;
-	wcex.lpszClassName = clazz;
-	wcex.hIconSm = NULL;
+	// the optional attributes go at the end, so that they can be cut off if the context can't be created with them
+	const int required = 8;
+	int count = required;
 
-	if (!RegisterClassExA(&wcex)) {
-		winxErrorMsg = (char*) "RegisterClassExA: Failed to register window class!";
-		return false;
-	}
+	// a no-error context can't also be a debug or robust one
+	winx->no_error = __winx_hint_opengl_no_error && !flags && winxHasGLXExtension("GLX_ARB_create_context_no_error");
+	winx->release_none = __winx_hint_opengl_release == WINX_RELEASE_NONE && winxHasGLXExtension("GLX_ARB_context_flush_control");
 
-	HWND fakeHndl;
-	HDC fakeDeviceContext;
-	HGLRC fakeRenderContext;
+	// glXGetProcAddress returns a stub for any name, only the extension string tells if it does anything
+	winx->copy_sub_buffer = glXCopySubBufferMESA && winxHasGLXExtension("GLX_MESA_copy_sub_buffer");
 
-	// create temporary window to get WGL context
-	fakeHndl = CreateWindowA(clazz, "WINX", WS_OVERLAPPEDWINDOW, 0, 0, 1, 1, NULL, NULL, hinstance, NULL);
-	if (!fakeHndl) {
-		winxErrorMsg = (char*) "CreateWindowA: Failed to create temporary window!";
-		return false;
+	if (winx->no_error) {
+		context_attributes[count ++] = GLX_CONTEXT_OPENGL_NO_ERROR_ARB;
+		context_attributes[count ++] = true;
 	}
 
-	fakeDeviceContext = GetDC(fakeHndl);
-	if (!fakeDeviceContext) {
-		winxErrorMsg = (char*) "GetDC: Failed to create temporary device context!";
-		return false;
+	if (winx->release_none) {
+		context_attributes[count ++] = GLX_CONTEXT_RELEASE_BEHAVIOR_ARB;
+		context_attributes[count ++] = GLX_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB;
 	}
 
-	PIXELFORMATDESCRIPTOR descriptor = {0};
+	context_attributes[count] = None;
+
+	// drivers can still refuse the optional attributes with an X error, catch it so that the default handler doesn't terminate the application
+	winxContextError = false;
+	XErrorHandler handler = XSetErrorHandler(winxContextErrorHandler);
+	winx->context = glXCreateContextAttribsARB(winx->display, config, NULL, true, context_attributes);
+	XSync(winx->display, false);
+
+	if ((!winx->context || winxContextError) && count != required) {
+		if (winx->context) {
+			glXDestroyContext(winx->display, winx->context);
+		}
+
+		winx->no_error = false;
+		winx->release_none = false;
+		context_attributes[required] = None;
+
+		winxContextError = false;
+		winx->context = glXCreateContextAttribsARB(winx->display, config, NULL, true, context_attributes);
+		XSync(winx->display, false);
+	}
+
+	XSetErrorHandler(handler);
+
+	if (!winx->context || winxContextError) {
+		winxErrorMsg = (char*) "glXCreateContextAttribsARB: Failed to create context";
+		return false;
+	}
+
+	glXMakeCurrent(winx->display, winx->window, winx->context);
+	winxInitGL();
+
+	return true;
+}
+
+// hints that the kept alive display state depends on, followed by the ones the kept alive window depends on
+static void winxGetPersistentHints(int* hints) {
+	const int values[WINX_PERSISTENT_HINTS] = {
+		__winx_hint_context, __winx_hint_red_bits, __winx_hint_green_bits, __winx_hint_blue_bits, __winx_hint_alpha_bits,
+		__winx_hint_depth_bits, __winx_hint_stencil_bits, __winx_hint_multisamples, __winx_hint_srgb,
+		__winx_hint_opengl_major, __winx_hint_opengl_minor, __winx_hint_opengl_core, __winx_hint_opengl_debug, __winx_hint_opengl_robust,
+		__winx_hint_opengl_no_error, __winx_hint_opengl_release, __winx_hint_input_samples
+	};
+
+	memcpy(hints, values, sizeof(values));
+}
+
+static bool winxOpenDisplay() {
+
+	// needed so that winxSwapBuffers() can be called from a render thread
+	XInitThreads();
+
+	// get display handle
+	winx->display = XOpenDisplay(NULL);
+	if (!winx->display) {
+		winxErrorMsg = (char*) "XOpenDisplay: Failed to acquire display handle!";
+		return false;
+	}
+
+	// GLX attributes
+	int attributes[] = {
+		GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB, true, // optional, skipped if not requested or supported
+		GLX_RENDER_TYPE, GLX_RGBA_BIT,
+		GLX_DRAWABLE_TYPE, GLX_WINDOW_BIT,
+		GLX_DOUBLEBUFFER, true,
+		GLX_RED_SIZE, __winx_hint_red_bits,
+		GLX_GREEN_SIZE, __winx_hint_green_bits,
+		GLX_BLUE_SIZE, __winx_hint_blue_bits,
+		GLX_DEPTH_SIZE, __winx_hint_depth_bits,
+		GLX_STENCIL_SIZE, __winx_hint_stencil_bits,
+		GLX_SAMPLE_BUFFERS, __winx_hint_multisamples ? 1 : 0,
+		GLX_SAMPLES, __winx_hint_multisamples,
+		None
+	};
+
+	int screen = DefaultScreen(winx->display);
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+
+		// software windows use plain 0x00RRGGBB pixels, windows without a context can use any visual
+		if (!XMatchVisualInfo(winx->display, screen, 24, TrueColor, &winx->info)) {
+			winxErrorMsg = (char*) "XMatchVisualInfo: Failed to find a TrueColor visual!";
+			return false;
+		}
+
+	} else {
+
+		// find frame buffer config matching our attributes, try again without sRGB if there is no such config
+		int count = 0;
+		GLXFBConfig* fbconfigs = NULL;
+
+		if (__winx_hint_srgb && (winxHasGLXExtension("GLX_ARB_framebuffer_sRGB") || winxHasGLXExtension("GLX_EXT_framebuffer_sRGB"))) {
+			fbconfigs = glXChooseFBConfig(winx->display, screen, attributes, &count);
+		}
+
+		if (!fbconfigs || !count) {
+			if (fbconfigs) XFree(fbconfigs);
+			fbconfigs = glXChooseFBConfig(winx->display, screen, attributes + 2, &count);
+		}
+
+		if (!fbconfigs || !count) {
+			winxErrorMsg = (char*) "glXChooseFBConfig: Failed to choose a frame buffer config!";
+			return false;
+		}
+
+		// the configs themselves are owned by the display, only the list needs to be freed
+		winx->config = fbconfigs[0];
+		XFree(fbconfigs);
+
+		int srgb = false;
+		glXGetFBConfigAttrib(winx->display, winx->config, GLX_FRAMEBUFFER_SRGB_CAPABLE_ARB, &srgb);
+		winx->srgb = srgb;
+
+		// find visual based on framebuffer's config
+		XVisualInfo* info = glXGetVisualFromFBConfig(winx->display, winx->config);
+		if (!info) {
+			winxErrorMsg = (char*) "glXGetVisualFromFBConfig: Failed to choose a visual!";
+			return false;
+		}
+
+		winx->info = *info;
+		XFree(info);
+
+	}
+
+#if defined(WINX_XCB)
+	// Xlib is still used for GLX and the event queue, XCB only sends the requests that can be pipelined
+	winx->connection = XGetXCBConnection(winx->display);
+#endif
+
+	const char* atom_names[] = {
+		"_NET_WM_ICON", "CARDINAL", // needed for window icon
+		"_NET_WM_STATE", "_NET_WM_STATE_FULLSCREEN", "_NET_WM_BYPASS_COMPOSITOR", // needed for fullscreen
+		"_NET_WM_STATE_HIDDEN", // needed to track visibility, minimized windows can stay mapped with some window managers
+		"WM_DELETE_WINDOW", // needed to handle the close button
+		"Abs Pressure", "Abs Tilt X", "Abs Tilt Y", "Abs MT Pressure" // needed to find the XInput2 valuators
+	};
+
+	Atom* atoms[] = {
+		&winx->net_wm_icon, &winx->cardinal,
+		&winx->net_wm_state, &winx->net_wm_state_fullscreen, &winx->net_wm_bypass_compositor,
+		&winx->net_wm_state_hidden,
+		&winx->wm_delete_window,
+		&winx->abs_pressure, &winx->abs_tilt_x, &winx->abs_tilt_y, &winx->abs_mt_pressure
+	};
+
+	winxInternAtoms(atom_names, atoms, sizeof(atoms) / sizeof(Atom*));
+
+	// needed to track monitors
+	int error_base;
+	if (!XRRQueryExtension(winx->display, &winx->randr_event, &error_base)) {
+		winx->randr_event = -1;
+	}
+
+	// needed for touch and pen input, touch events were added in XInput 2.2
+	int event_base;
+	int major = 2;
+	winx->xi_minor = 2;
+
+	if (!XQueryExtension(winx->display, "XInputExtension", &winx->xi_opcode, &event_base, &error_base) || XIQueryVersion(winx->display, &major, &winx->xi_minor) != Success || major < 2) {
+		winx->xi_opcode = -1;
+	}
+
+	// held keys should only repeat the press events, not send fake releases
+	Bool supported = False;
+	XkbSetDetectableAutoRepeat(winx->display, True, &supported);
+	winx->detectable_repeat = supported;
+
+	return true;
+}
+
+static bool winxCreateWindow(int width, int height, const char* title) {
+	Window root = RootWindow(winx->display, winx->info.screen);
+
+	// set X11 window attributes
+	XSetWindowAttributes x11_attributes;
+	x11_attributes.background_pixel = 0;
+	x11_attributes.border_pixel = 0;
+	x11_attributes.colormap = XCreateColormap(winx->display, root, winx->info.visual, AllocNone);
+
+	x11_attributes.event_mask = winxGetEventMask();
+	winx->event_mask = x11_attributes.event_mask;
+	winx->colormap = x11_attributes.colormap;
+
+	// a kept display still holds the size of its previous window
+	winx->width = width;
+	winx->height = height;
+
+	unsigned long mask = CWBackPixel | CWBorderPixel | CWColormap | CWEventMask;
+
+	// finally create X11 window
+	winx->window = XCreateWindow(winx->display, root, 0, 0, width, height, 0, winx->info.depth, InputOutput, winx->info.visual, mask, &x11_attributes);
+	winx->visual = winx->info.visual;
+
+	// set name
+	winxSetTitle(title);
+
+	// show X11 window
+	XMapWindow(winx->display, winx->window);
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winx->gc = XCreateGC(winx->display, winx->window, 0, NULL);
+		winx->shm = XShmQueryExtension(winx->display);
+		winx->shm_completion = XShmGetEventBase(winx->display) + ShmCompletion;
+
+		if (!winxCreateFrameBuffers(width, height)) {
+			return false;
+		}
+	} else if (winx->mode == WINX_CONTEXT_OPENGL) {
+		if (!winxCreateContext(winx->config, &winx->info)) {
+			return false;
+		}
+	}
+
+	// needed to handle the close button
+	XSetWMProtocols(winx->display, winx->window, &(winx->wm_delete_window), 1);
+
+	// needed to track monitors
+	if (winx->randr_event != -1) {
+		XRRSelectInput(winx->display, winx->window, RRScreenChangeNotifyMask | RRCrtcChangeNotifyMask | RROutputChangeNotifyMask);
+	}
+
+	if (__winx_hint_input_samples && winx->xi_opcode != -1) {
+		winxUpdateInputDevices();
+	}
+
+	return true;
+}
+
+// also used when winxOpen() failed, so the window could be only partially created
+static void winxDestroyWindow() {
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxDeleteFrameBuffers();
+
+		if (winx->gc) {
+			XFreeGC(winx->display, winx->gc);
+		}
+	} else if (winx->mode == WINX_CONTEXT_OPENGL && winx->context) {
+		// the render thread has released the context, take it back to free the objects created in it
+		glXMakeCurrent(winx->display, winx->window, winx->context);
+		winxFreeGL();
+		glXMakeCurrent(winx->display, None, NULL);
+		glXDestroyContext(winx->display, winx->context);
+	}
+
+	XDestroyWindow(winx->display, winx->window);
+	XFreeColormap(winx->display, winx->colormap);
+	winx->window = 0;
+	winx->context = NULL;
+	winx->gc = NULL;
+}
+
+static void winxCloseDisplay() {
+	if (winx->display) {
+		XCloseDisplay(winx->display);
+	}
+
+	free(winx->devices);
+	free(winx->samples);
+	free(winx->monitors);
+	free(winx);
+	winx = NULL;
+}
+
+// show the kept alive window again, as if it was just created
+static bool winxReuseWindow(int width, int height, const char* title) {
+
+	// drop everything that was sent to the hidden window
+	XSync(winx->display, true);
+
+	if (winx->width != width || winx->height != height) {
+		winx->width = width;
+		winx->height = height;
+
+		if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+			winxDeleteFrameBuffers();
+
+			if (!winxCreateFrameBuffers(width, height)) {
+				return false;
+			}
+		}
+	}
+
+	XResizeWindow(winx->display, winx->window, width, height);
+	winxSetTitle(title);
+	XMapWindow(winx->display, winx->window);
+
+	if (winx->mode == WINX_CONTEXT_OPENGL) {
+		glXMakeCurrent(winx->display, winx->window, winx->context);
+		winxInitGL();
+	}
+
+	return true;
+}
+
+bool winxOpen(int width, int height, const char* title) {
+	int hints[WINX_PERSISTENT_HINTS];
+	winxGetPersistentHints(hints);
+
+	winx = winxPersistent;
+	winxPersistent = NULL;
+
+	// the state kept alive by winxClose() can only be reused if it was created with the same hints
+	if (winx && winx->window && memcmp(winx->hints, hints, sizeof(hints)) != 0) {
+		winxDestroyWindow();
+	}
+
+	if (winx && memcmp(winx->hints, hints, WINX_PERSISTENT_DISPLAY_HINTS * sizeof(int)) != 0) {
+		winxCloseDisplay();
+	}
+
+	bool reuse = winx != NULL;
+
+	if (!reuse) {
+		winx = (WinxHandle*) calloc(1, sizeof(WinxHandle));
+		winx->mode = __winx_hint_context;
+	}
+
+	// a kept display can still get a new window, which is created with the current hints
+	memcpy(winx->hints, hints, sizeof(hints));
+	winx->persistent = __winx_hint_persistent;
+	winx->focused = false;
+	winx->mapped = false;
+	winx->obscured = false;
+	winx->hidden = false;
+	winx->visible = false;
+	winx->capture = false;
+	winx->cursor_icon = NULL;
+	winx->lazy = __winx_hint_lazy;
+	winx->throttle = __winx_hint_throttle;
+	winx->throttle_time = 0;
+	WINX_SET_REDRAW(true);
+	memset(winx->keys, 0, sizeof(winx->keys));
+
+	struct timespec spec;
+	clock_gettime(CLOCK_REALTIME, &spec);
+	winx->time = spec.tv_sec;
+
+	// set dummy function pointers
+	winxResetEventHandles();
+
+	if (!reuse && !winxOpenDisplay()) {
+		winxCloseDisplay();
+		return false;
+	}
+
+	// nothing of a half created window is worth keeping alive
+	if (winx->window ? !winxReuseWindow(width, height, title) : !winxCreateWindow(width, height, title)) {
+		winxDestroyWindow();
+		winxCloseDisplay();
+		return false;
+	}
+
+	// the monitors and the keyboard mapping could have changed while the display was not used
+	if (winx->randr_event != -1) {
+		winxUpdateMonitors();
+	}
+
+	winxUpdateKeysyms();
+
+	// set vsync
+	winxSetVsync(__winx_hint_vsync);
+
+	return true;
+}
+
+static void winxWaitForEvents() {
+	// XPending() flushes the output buffer and reads all events that already arrived
+	if (XPending(winx->display) == 0) {
+		winxPollSources(ConnectionNumber(winx->display), -1);
+	}
+}
+
+static void winxProcessEvents() {
+	// the window could have been closed from inside of one of the event handlers
+	while (winx && XPending(winx->display) > 0) {
+
+		XEvent event;
+		XNextEvent(winx->display, &event);
+
+		// a handler can close the window, keep the display so that the cookie data can still be freed
+		Display* display = winx->display;
+
+		// load the cookie data first, it can only be read once and both winx and the hook may need it
+		const bool cookie = event.type == GenericEvent && XGetEventData(display, &event.xcookie);
+
+		if (!winx->native_after && winx->native(&event)) {
+			if (cookie) XFreeEventData(display, &event.xcookie);
+			continue;
+		}
+
+		// each case calls its handle last, as the handle can close the window and leave winx NULL
+		switch (event.type) {
+
+			case ClientMessage:
+				if ((Atom) event.xclient.data.l[0] == winx->wm_delete_window) {
+					WINX_SET_REDRAW(true); // wake up the lazy event loop
+					winx->close();
+					break;
+				}
+				break;
+
+			case Expose:
+				WINX_SET_REDRAW(true);
+				winx->expose(event.xexpose.x, event.xexpose.y, event.xexpose.width, event.xexpose.height);
+				break;
+
+			case KeyPress: {
+				WINX_SET_REDRAW(true);
+
+				// the handle can close the window, so it has to be called last
+				const bool repeated = winx->keys[event.xkey.keycode];
+				winx->keys[event.xkey.keycode] = true;
+				winx->keyboard(repeated ? WINX_REPEATED : WINX_PRESSED, winx->keysyms[event.xkey.keycode]);
+				break;
+			}
+
+			case KeyRelease:
+				WINX_SET_REDRAW(true);
+
+				// without detectable auto-repeat the X server sends a release immediately followed
+				// by a press with the same timestamp for each repeat, merge them into a single repeat
+				if (!winx->detectable_repeat && XEventsQueued(winx->display, QueuedAfterReading)) {
+					XEvent next;
+					XPeekEvent(winx->display, &next);
+
+					if (next.type == KeyPress && next.xkey.keycode == event.xkey.keycode && next.xkey.time == event.xkey.time) {
+						XNextEvent(winx->display, &next);
+						winx->keyboard(WINX_REPEATED, winx->keysyms[event.xkey.keycode]);
+						break;
+					}
+				}
+
+				winx->keys[event.xkey.keycode] = false;
+				winx->keyboard(WINX_RELEASED, winx->keysyms[event.xkey.keycode]);
+				break;
+
+			case MappingNotify:
+				if (event.xmapping.request == MappingKeyboard || event.xmapping.request == MappingModifier) {
+					XRefreshKeyboardMapping(&event.xmapping);
+					winxUpdateKeysyms();
+				}
+				break;
+
+			case ButtonPress:
+				WINX_SET_REDRAW(true);
+
+				if (event.xbutton.button == Button4) {
+					winx->scroll(1);
+					break;
+				}
+
+				if (event.xbutton.button == Button5) {
+					winx->scroll(-1);
+					break;
+				}
+
+				winx->button(WINX_PRESSED, event.xbutton.button);
+				break;
+
+			case ButtonRelease:
+				WINX_SET_REDRAW(true);
+				winx->button(WINX_RELEASED, event.xbutton.button);
+				break;
+
+			case MotionNotify:
+				WINX_SET_REDRAW(true);
+				winx->cursor(event.xmotion.x, event.xmotion.y);
+				break;
+
+			case ConfigureNotify:
+				if (winx->width != event.xconfigure.width || winx->height != event.xconfigure.height) {
+					WINX_SET_REDRAW(true);
+
+					// on failure leave no half created buffers behind, winxGetPixels() returns NULL until the next resize
+					if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+						winxDeleteFrameBuffers();
+
+						if (!winxCreateFrameBuffers(event.xconfigure.width, event.xconfigure.height)) {
+							winxDeleteFrameBuffers();
+						}
+					}
+				}
+
+				// if the window was reparented by the window manager only
+				// the synthetic events contain the position relative to the root window
+				if (event.xconfigure.send_event || !winx->reparented) {
+					winx->x = event.xconfigure.x;
+					winx->y = event.xconfigure.y;
+				}
+
+				winx->width = event.xconfigure.width;
+				winx->height = event.xconfigure.height;
+				winx->resize(event.xconfigure.width, event.xconfigure.height);
+
+				// the resize handle could have closed the window
+				if (winx) {
+					winxUpdateWindowMonitor(false);
+				}
+				break;
+
+			case ReparentNotify:
+				winx->reparented = event.xreparent.parent != DefaultRootWindow(winx->display);
+				break;
+
+			case MapNotify:
+				winx->mapped = true;
+				winxUpdateVisibility();
+				break;
+
+			case UnmapNotify:
+				winx->mapped = false;
+				winxUpdateVisibility();
+				break;
+
+			case VisibilityNotify:
+				winx->obscured = event.xvisibility.state == VisibilityFullyObscured;
+				winxUpdateVisibility();
+				break;
+
+			case PropertyNotify:
+				if (event.xproperty.atom == winx->net_wm_state) {
+					winxRequestStateHidden();
+				}
+				break;
+
+			case FocusIn:
+				WINX_SET_REDRAW(true);
+				winx->focused = true;
+				winxUpdateCursorState(winx->capture, winx->cursor_icon);
+				winx->focus(true);
+				break;
+
+			case FocusOut:
+				WINX_SET_REDRAW(true);
+				winx->focused = false;
+				memset(winx->keys, 0, sizeof(winx->keys)); // the key releases won't arrive
+				winxUpdateCursorState(false, NULL);
+				winx->focus(false);
+				break;
+
+			case GenericEvent:
+				if (cookie && event.xcookie.extension == winx->xi_opcode) {
+					winxProcessInputEvent(&event.xcookie);
+				}
+				break;
+
+			default:
+				if (winx->randr_event != -1 && (event.type == winx->randr_event + RRScreenChangeNotify || event.type == winx->randr_event + RRNotify)) {
+					XRRUpdateConfiguration(&event);
+					winxUpdateMonitors();
+					winxUpdateWindowMonitor(true);
+					break;
+				}
+
+				if (event.type == winx->shm_completion && winx->mode == WINX_CONTEXT_SOFTWARE) {
+					for (int i = 0; i < 2; i ++) {
+						if (winx->buffers[i].image && winx->buffers[i].segment.shmseg == ((XShmCompletionEvent*) &event)->shmseg) {
+							winx->buffers[i].busy = false;
+						}
+					}
+				}
+				break;
+
+		}
+
+		// the display is already closed if one of the handles closed the window
+		if (winx && winx->native_after) {
+			winx->native(&event);
+		}
+
+		// with WINX_PERSISTENT_DISPLAY the connection outlives winxClose(), otherwise XCloseDisplay() already freed the data
+		if (cookie && (winx || winxPersistent)) {
+			XFreeEventData(display, &event.xcookie);
+		}
+
+	}
+
+	if (winx) {
+		winxReceiveStateHidden();
+		winxPollSources(-1, 0);
+		winxDispatchSources();
+	}
+}
+
+void winxPollEvents() {
+	winx->sample_count = 0;
+	winxProcessEvents();
+
+	// in lazy mode block until there is something to redraw
+	while (winx && winx->lazy && !WINX_GET_REDRAW()) {
+		winxWaitForEvents();
+		winxProcessEvents();
+	}
+}
+
+void winxWaitEvents() {
+	winx->sample_count = 0;
+	winxWaitForEvents();
+	winxProcessEvents();
+}
+
+void winxMakeContextCurrent() {
+	WINX_CONTEXT_ASSERT("winxMakeContextCurrent");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxMakeContextCurrent: Current window has no OpenGL context!";
+		return;
+	}
+
+	if (!glXMakeCurrent(winx->display, winx->window, winx->context)) {
+		winxErrorMsg = (char*) "glXMakeCurrent: Failed to make context current!";
+	}
+}
+
+void winxReleaseContext() {
+	WINX_CONTEXT_ASSERT("winxReleaseContext");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		return;
+	}
+
+	glXMakeCurrent(winx->display, None, NULL);
+}
+
+void winxSwapBuffers() {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxPresentPixels(NULL, 0);
+		return;
+	}
+
+	// the frame was presented by Vulkan
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	winxEndFrame();
+	glXSwapBuffers(winx->display, winx->window);
+}
+
+void winxSwapBuffersWithDamage(const int* rects, int count) {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxPresentPixels(rects, count);
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	winxEndFrame();
+
+	if (!winx->copy_sub_buffer || !rects || count <= 0) {
+		glXSwapBuffers(winx->display, winx->window);
+		return;
+	}
+
+	// GLX_MESA_copy_sub_buffer copies the given regions from the back buffer
+	// to the front buffer, leaving the back buffer intact, it expects the origin to be in the bottom-left corner
+	for (int i = 0; i < count * 4; i += 4) {
+		glXCopySubBufferMESA(winx->display, winx->window, rects[i + 0], winx->height - rects[i + 1] - rects[i + 3], rects[i + 2], rects[i + 3]);
+	}
+}
+
+bool winxGetDamageSupport() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetDamageSupport: No active winx context!";
+		return false;
+	}
+
+	return winx->mode == WINX_CONTEXT_SOFTWARE || (winx->mode == WINX_CONTEXT_OPENGL && winx->copy_sub_buffer);
+}
+
+const WinxInputSample* winxGetInputSamples(int* count) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetInputSamples: No active winx context!";
+		*count = 0;
+		return NULL;
+	}
+
+	*count = winx->sample_count;
+	return winx->samples;
+}
+
+bool winxGetPresentTiming(double* time, double* interval) {
+	// GLX has no portable way of reporting when a frame was actually shown
+	*time = 0;
+	*interval = 0;
+	return false;
+}
+
+unsigned int* winxGetPixels() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetPixels: No active winx context!";
+		return NULL;
+	}
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxGetPixels: Current window is not a software window!";
+		return NULL;
+	}
+
+	if (!winx->buffers[winx->buffer].image) {
+		winxErrorMsg = (char*) "winxGetPixels: Failed to create frame buffer!";
+		return NULL;
+	}
+
+	return (unsigned int*) winx->buffers[winx->buffer].image->data;
+}
+
+void winxPresentPixels(const int* rects, int count) {
+	WINX_CONTEXT_ASSERT("winxPresentPixels");
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxPresentPixels: Current window is not a software window!";
+		return;
+	}
+
+	WINX_SET_REDRAW(false);
+
+	int full[4] = {0, 0, winx->width, winx->height};
+	WinxFrameBuffer* back = &winx->buffers[winx->buffer];
+
+	if (!back->image) {
+		winxErrorMsg = (char*) "winxPresentPixels: Failed to create frame buffer!";
+		return;
+	}
+
+	if (!rects || count <= 0) {
+		rects = full;
+		count = 1;
+	}
+
+	int rect[4];
+	int last = -1;
+
+	for (int i = 0; i < count * 4; i += 4) {
+		if (winxClipRect(rects + i, back->image->width, back->image->height, rect)) {
+			last = i;
+		}
+	}
+
+	for (int i = 0; i <= last; i += 4) {
+		if (!winxClipRect(rects + i, back->image->width, back->image->height, rect)) {
+			continue;
+		}
+
+		if (winx->shm) {
+			// requests are processed in order, so the completion of the last region means the whole buffer is free again
+			XShmPutImage(winx->display, winx->window, winx->gc, back->image, rect[0], rect[1], rect[0], rect[1], rect[2], rect[3], i == last);
+		} else {
+			XPutImage(winx->display, winx->window, winx->gc, back->image, rect[0], rect[1], rect[0], rect[1], rect[2], rect[3]);
+		}
+	}
+
+	XFlush(winx->display);
+
+	if (!winx->shm || last == -1) {
+		return;
+	}
+
+	// the server reads from the presented buffer asynchronously,
+	// so continue drawing in the other one once the server is done with it
+	back->busy = true;
+	winx->buffer ^= 1;
+
+	WinxFrameBuffer* next = &winx->buffers[winx->buffer];
+	winxWaitFrameBuffer(next);
+
+	// bring the new back buffer up to date with what was just presented
+	const int stride = back->image->bytes_per_line;
+
+	for (int i = 0; i < count * 4; i += 4) {
+		if (!winxClipRect(rects + i, back->image->width, back->image->height, rect)) {
+			continue;
+		}
+
+		for (int row = rect[1]; row < rect[1] + rect[3]; row ++) {
+			memcpy(next->image->data + row * stride + rect[0] * 4, back->image->data + row * stride + rect[0] * 4, rect[2] * 4);
+		}
+	}
+}
+
+void winxClose() {
+	winxFreeSources();
+	winxFreeCursors();
+
+	// only hide the window, so that it can be shown again by the next winxOpen()
+	if (winx->persistent == WINX_PERSISTENT_WINDOW) {
+
+		// winxReuseWindow() drops the events of the hidden window, so the pending ShmCompletion events have to arrive now
+		if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+			winxWaitFrameBuffer(winx->buffers + 0);
+			winxWaitFrameBuffer(winx->buffers + 1);
+		}
+
+		XUnmapWindow(winx->display, winx->window);
+
+		// the render thread has released the context, take it back to free the objects created in it
+		if (winx->mode == WINX_CONTEXT_OPENGL) {
+			glXMakeCurrent(winx->display, winx->window, winx->context);
+			winxFreeGL();
+			glXMakeCurrent(winx->display, None, NULL);
+		}
+
+		XFlush(winx->display);
+		winxPersistent = winx;
+		winx = NULL;
+		return;
+	}
+
+	winxDestroyWindow();
+
+	// keep the display connection, frame buffer config and atoms for the next winxOpen()
+	if (winx->persistent == WINX_PERSISTENT_DISPLAY) {
+		XFlush(winx->display);
+		winxPersistent = winx;
+		winx = NULL;
+		return;
+	}
+
+	winxCloseDisplay();
+}
+
+void winxTerminate() {
+	if (winx) {
+		winxErrorMsg = (char*) "winxTerminate: Window needs to be closed first!";
+		return;
+	}
+
+	winx = winxPersistent;
+	winxPersistent = NULL;
+
+	if (!winx) {
+		return;
+	}
+
+	if (winx->window) {
+		winxDestroyWindow();
+	}
+
+	winxCloseDisplay();
+}
+
+void* winxGetProcAddress(const char* name) {
+	return (void*) glXGetProcAddress((const unsigned char*) name);
+}
+
+// the Vulkan loader is only opened when it's needed, so that winx doesn't depend on it
+static bool winxLoadVulkan() {
+	if (!vkGetInstanceProcAddr) {
+		void* library = dlopen("libvulkan.so.1", RTLD_NOW | RTLD_LOCAL);
+
+		if (!library) {
+			library = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+		}
+
+		if (!library) {
+			winxErrorMsg = (char*) "dlopen: Failed to load the Vulkan loader!";
+			return false;
+		}
+
+		vkGetInstanceProcAddr = (PFNVKGETINSTANCEPROCADDRPROC) dlsym(library, "vkGetInstanceProcAddr");
+	}
+
+	return vkGetInstanceProcAddr != NULL;
+}
+
+const char** winxGetRequiredVulkanInstanceExtensions(int* count) {
+#if defined(WINX_XCB)
+	static const char* extensions[] = {"VK_KHR_surface", "VK_KHR_xcb_surface"};
+#else
+	static const char* extensions[] = {"VK_KHR_surface", "VK_KHR_xlib_surface"};
+#endif
+
+	if (!winxLoadVulkan()) {
+		*count = 0;
+		return NULL;
+	}
+
+	*count = 2;
+	return extensions;
+}
+
+bool winxCreateVulkanSurface(void* instance, const void* allocator, void* surface) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: No active winx context!";
+		return false;
+	}
+
+	if (!winxLoadVulkan()) {
+		return false;
+	}
+
+#if defined(WINX_XCB)
+	PFNVKCREATEXCBSURFACEKHRPROC vkCreateXcbSurfaceKHR = (PFNVKCREATEXCBSURFACEKHRPROC) vkGetInstanceProcAddr(instance, "vkCreateXcbSurfaceKHR");
+
+	if (!vkCreateXcbSurfaceKHR) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: Instance was created without VK_KHR_xcb_surface!";
+		return false;
+	}
+
+	VkXcbSurfaceCreateInfoKHR info = {VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR, NULL, 0, winx->connection, (xcb_window_t) winx->window};
+
+	if (vkCreateXcbSurfaceKHR(instance, &info, allocator, surface) != 0) {
+		winxErrorMsg = (char*) "vkCreateXcbSurfaceKHR: Failed to create surface!";
+		return false;
+	}
+#else
+	PFNVKCREATEXLIBSURFACEKHRPROC vkCreateXlibSurfaceKHR = (PFNVKCREATEXLIBSURFACEKHRPROC) vkGetInstanceProcAddr(instance, "vkCreateXlibSurfaceKHR");
+
+	if (!vkCreateXlibSurfaceKHR) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: Instance was created without VK_KHR_xlib_surface!";
+		return false;
+	}
+
+	VkXlibSurfaceCreateInfoKHR info = {VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR, NULL, 0, winx->display, winx->window};
+
+	if (vkCreateXlibSurfaceKHR(instance, &info, allocator, surface) != 0) {
+		winxErrorMsg = (char*) "vkCreateXlibSurfaceKHR: Failed to create surface!";
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+void winxSetTitle(const char* title) {
+	WINX_CONTEXT_ASSERT("winxSetTitle");
+
+	XStoreName(winx->display, winx->window, title);
+	XSetIconName(winx->display, winx->window, title);
+}
+
+void winxSetIcon(int width, int height, unsigned char* buffer) {
+	WINX_CONTEXT_ASSERT("winxSetIcon");
+
+	// We need to convert RGBA byte array to a suported format
+	// X11 expects the icon in format [[long: width] [long: height] [long: bgra]...]...
+
+	const int size = width * height;
+	unsigned long* icon = (unsigned long*) malloc(sizeof(long) * (size + 2));
+
+	icon[0] = width;
+	icon[1] = height;
+
+	for (int i = 0, j = 2; i < size * 4; i += 4) {
+		icon[j ++] = buffer[i + 2] | buffer[i + 1] << 8 | buffer[i + 0] << 16 | buffer[i + 3] << 24;
+	}
+
+	XChangeProperty(winx->display, winx->window, winx->net_wm_icon, winx->cardinal, 32, PropModeReplace, (const unsigned char*) icon, size + 2);
+
+	free(icon);
+}
+
+void winxSetFullscreen(bool fullscreen) {
+	WINX_CONTEXT_ASSERT("winxSetFullscreen");
+
+	// ask the compositor to unredirect the window while it is fullscreen, so that
+	// it can be scanned out directly, 0 means that there is no preference
+	unsigned long bypass = fullscreen ? 1 : 0;
+	XChangeProperty(winx->display, winx->window, winx->net_wm_bypass_compositor, winx->cardinal, 32, PropModeReplace, (const unsigned char*) &bypass, 1);
+
+	// until the window is mapped the window manager reads the state from the property when it manages the window,
+	// the message is still sent as the map request could already be handled even if the MapNotify did not arrive yet
+	if (!winx->mapped) {
+		if (fullscreen) {
+			XChangeProperty(winx->display, winx->window, winx->net_wm_state, XA_ATOM, 32, PropModeReplace, (const unsigned char*) &winx->net_wm_state_fullscreen, 1);
+		} else {
+			XDeleteProperty(winx->display, winx->window, winx->net_wm_state);
+		}
+	}
+
+	// once the window is mapped the state needs to be changed by the window manager
+	// see https://specifications.freedesktop.org/wm-spec/latest/ar01s05.html#id-1.6.8
+	XEvent event = {0};
+	event.xclient.type = ClientMessage;
+	event.xclient.window = winx->window;
+	event.xclient.message_type = winx->net_wm_state;
+	event.xclient.format = 32;
+	event.xclient.data.l[0] = fullscreen ? 1 : 0; // _NET_WM_STATE_ADD or _NET_WM_STATE_REMOVE
+	event.xclient.data.l[1] = winx->net_wm_state_fullscreen;
+	event.xclient.data.l[2] = 0;
+	event.xclient.data.l[3] = 1; // normal application
+
+	XSendEvent(winx->display, DefaultRootWindow(winx->display), false, SubstructureNotifyMask | SubstructureRedirectMask, &event);
+	XFlush(winx->display);
+}
+
+WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, int x, int y) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateCursorIcon: No active winx context!";
+		return NULL;
+	}
+
+	XcursorImage* image = XcursorImageCreate(width, height);
+	if (!image) {
+		winxErrorMsg = (char*) "XcursorImageCreate: Failed to create cursor image!";
+		return NULL;
+	}
+
+	image->xhot = x;
+	image->yhot = y;
+	XcursorPixel* pixels = image->pixels;
+
+	for (int i = 0, j = 0; i < width * height * 4; i += 4) {
+		pixels[j ++] = buffer[i + 2] | buffer[i + 1] << 8 | buffer[i + 0] << 16 | buffer[i + 3] << 24;
+	}
+
+	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
+	cursor->native = XcursorImageLoadCursor(winx->display, image);
+	XcursorImageDestroy(image);
+	winxTrackCursor(cursor);
+
+	return cursor;
+}
+
+WinxCursor* winxCreateNullCursorIcon() {
+	unsigned char pixels[1 * 1 * 4] = {0, 0, 0, 0};
+	return winxCreateCursorIcon(1, 1, pixels, 0, 0);
+}
+
+void winxDeleteCursorIcon(WinxCursor* cursor) {
+	WINX_CONTEXT_ASSERT("winxDeleteCursorIcon");
+
+	if (cursor && winxUntrackCursor(cursor)) {
+		XFreeCursor(winx->display, cursor->native);
+		free(cursor);
+	}
+}
+
+void winxSetVsync(int vsync) {
+	WINX_CONTEXT_ASSERT("winxSetVsync");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		return;
+	}
+
+	if (glXSwapIntervalEXT) {
+		glXSwapIntervalEXT(winx->display, winx->window, __winx_hint_vsync);
+	} else {
+		if (glXSwapIntervalMESA) {
+			glXSwapIntervalMESA(__winx_hint_vsync == WINX_VSYNC_ADAPTIVE ? WINX_VSYNC_ENABLED : __winx_hint_vsync);
+		}
+	}
+}
+
+void winxSetFocus() {
+	WINX_CONTEXT_ASSERT("winxSetFocus");
+
+	XSetInputFocus(winx->display, winx->window, RevertToNone, CurrentTime);
+
+	// this doesn't seem to actually bring the window up
+	// investigate if there is a more reliable solution
+	XRaiseWindow(winx->display, winx->window);
+	XFlush(winx->display);
+}
+
+void winxSetCursorPos(int x, int y) {
+	WINX_CONTEXT_ASSERT("winxSetCursorPos");
+
+	XWarpPointer(winx->display, None, winx->window, 0, 0, 0, 0, x, y);
+	XFlush(winx->display);
+}
+
+void* winxGetNativeDisplay() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeDisplay: No active winx context!";
+		return NULL;
+	}
+
+	return winx->display;
+}
+
+void* winxGetNativeWindow() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeWindow: No active winx context!";
+		return NULL;
+	}
+
+	return (void*) winx->window;
+}
+
+double winxGetTime() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetTime: No active winx context!";
+		return 0;
+	}
+
+	struct timespec spec;
+	clock_gettime(CLOCK_REALTIME, &spec);
+	return (spec.tv_sec - winx->time) + (spec.tv_nsec / (double) 1e+9);
+}
+
+#endif // GLX
+
+// begin winx Wayland implementation
+#if defined(WINX_WAYLAND)
+
+#include <wayland-client.h>
+#include <wayland-egl.h>
+#include <wayland-cursor.h>
+#include <xkbcommon/xkbcommon.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <linux/input-event-codes.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <poll.h>
+#include <time.h>
+#include <dlfcn.h>
+
+// generated by wayland-scanner from wayland-protocols
+#include "xdg-shell-client-protocol.h"
+#include "presentation-time-client-protocol.h"
+
+// copied from vulkan_core.h and vulkan_wayland.h
+typedef void (*PFNVKVOIDFUNCTIONPROC) (void);
+typedef PFNVKVOIDFUNCTIONPROC (*PFNVKGETINSTANCEPROCADDRPROC) (void* instance, const char* name);
+
+typedef struct {
+	int sType;
+	const void* pNext;
+	unsigned int flags;
+	struct wl_display* display;
+	struct wl_surface* surface;
+} VkWaylandSurfaceCreateInfoKHR;
+
+typedef int (*PFNVKCREATEWAYLANDSURFACEKHRPROC) (void* instance, const VkWaylandSurfaceCreateInfoKHR* info, const void* allocator, void* surface);
+
+#define VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR 1000006000
+
+static PFNVKGETINSTANCEPROCADDRPROC vkGetInstanceProcAddr;
+
+// bind the newest xdg_wm_base version whose events are known to the generated header
+#if defined(XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+#	define WINX_XDG_VERSION 6
+#elif defined(XDG_TOPLEVEL_WM_CAPABILITIES_SINCE_VERSION)
+#	define WINX_XDG_VERSION 5
+#elif defined(XDG_TOPLEVEL_CONFIGURE_BOUNDS_SINCE_VERSION)
+#	define WINX_XDG_VERSION 4
+#else
+#	define WINX_XDG_VERSION 2
+#endif
+
+// winx cursor image struct
+struct WinxCursor_s {
+	struct wl_buffer* buffer;
+	int width;
+	int height;
+	int x;
+	int y;
+	WinxCursor* next;
+};
+
+// software frame buffer struct
+typedef struct {
+	struct wl_buffer* buffer;
+	unsigned int* pixels;
+	size_t size;
+	bool busy;
+} WinxFrameBuffer;
+
+// single wl_output with the monitor info collected from its events
+typedef struct {
+	struct wl_output* output;
+	uint32_t name;
+	WinxMonitor info;
+} WinxOutput;
+
+// winx global state struct
+typedef struct {
+	struct wl_display* display;
+	struct wl_registry* registry;
+	struct wl_compositor* compositor;
+	struct wl_shm* shm;
+	struct wl_seat* seat;
+	struct wl_pointer* seat_pointer;
+	struct wl_keyboard* seat_keyboard;
+	struct xdg_wm_base* wm_base;
+	struct wp_presentation* presentation;
+	clockid_t presentation_clock;
+
+	struct wl_surface* surface;
+	struct xdg_surface* xdg_surface;
+	struct xdg_toplevel* toplevel;
+	struct wl_egl_window* egl_window;
+	EGLDisplay egl_display;
+	EGLContext context;
+	EGLSurface egl_surface;
+	PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC eglSwapBuffersWithDamage;
+	bool preserved;
+	bool no_error;
+	bool release_none;
+	bool srgb;
+
+	struct wl_surface* cursor_surface;
+	struct wl_cursor_theme* cursor_theme;
+	uint32_t pointer_serial;
+
+	struct xkb_context* xkb;
+	struct xkb_keymap* keymap;
+	int repeat_rate;
+	int repeat_delay;
+	int repeat_key;
+	double repeat_time;
+
+	int mode;
+	int buffer;
+	WinxFrameBuffer buffers[2];
+
+	int monitor;
+	int monitor_count;
+	WinxMonitor* monitors;
+	int output_count;
+	WinxOutput* outputs;
+
+	int x;
+	int y;
+	int width;
+	int height;
+	int pending_width;
+	int pending_height;
+	bool pending_focused;
+	bool pending_hidden;
+	bool configured;
+	bool dispatching;
+	bool closing;
+
+	bool focused;
+	bool mapped;
+	bool obscured;
+	bool hidden;
+	bool visible;
+	bool capture;
+	bool lazy;
+	long redraw;
+	int throttle;
+	double throttle_time;
+	bool presented;
+	double present_time;
+	double present_interval;
+	time_t time;
+	WinxCursor* cursor_icon;
+	WinxCursor* cursors;
+	WinxCursorEventHandle cursor;
+	WinxButtonEventHandle button;
+	WinxKeyboardEventHandle keyboard;
+	WinxScrollEventHandle scroll;
+	WinxCloseEventHandle close;
+	WinxResizeEventHandle resize;
+	WinxFocusEventHandle focus;
+	WinxExposeEventHandle expose;
+	WinxMonitorEventHandle monitor_change;
+	WinxVisibilityEventHandle visibility;
+	WinxNativeEventHandle native;
+	bool native_after;
+} WinxHandle;
+
+static WinxHandle* winx = NULL;
+
+static void winxSleep(double seconds) {
+	struct timespec spec;
+	spec.tv_sec = (time_t) seconds;
+	spec.tv_nsec = (long) ((seconds - spec.tv_sec) * 1e+9);
+
+	nanosleep(&spec, NULL);
+}
+
+// create an anonymous shared memory file, used for the wl_shm buffers
+static int winxCreateShmFile(size_t size) {
+	char name[64];
+
+	for (int i = 0; i < 100; i ++) {
+		snprintf(name, sizeof(name), "/winx-%d-%d-%ld", (int) getpid(), i, (long) clock());
+		int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+		if (fd >= 0) {
+			shm_unlink(name);
+
+			if (ftruncate(fd, size) == 0) {
+				return fd;
+			}
+
+			close(fd);
+			return -1;
+		}
+	}
+
+	return -1;
+}
+
+// create a wl_buffer backed by shared memory, the returned mapping can be written to directly
+static struct wl_buffer* winxCreateShmBuffer(int width, int height, uint32_t format, void** pixels) {
+	const size_t size = (size_t) width * height * 4;
+	int fd = winxCreateShmFile(size);
+
+	if (fd < 0) {
+		return NULL;
+	}
+
+	void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if (memory == MAP_FAILED) {
+		close(fd);
+		return NULL;
+	}
+
+	struct wl_shm_pool* pool = wl_shm_create_pool(winx->shm, fd, size);
+	struct wl_buffer* buffer = wl_shm_pool_create_buffer(pool, 0, width, height, width * 4, format);
+
+	// the buffer keeps the memory alive on the compositor side
+	wl_shm_pool_destroy(pool);
+	close(fd);
+
+	*pixels = memory;
+	return buffer;
+}
+
+static void winxBufferRelease(void* data, struct wl_buffer* buffer) {
+	((WinxFrameBuffer*) data)->busy = false;
+}
+
+static const struct wl_buffer_listener winxBufferListener = {
+	.release = winxBufferRelease
+};
+
+static bool winxCreateFrameBuffers(int width, int height) {
+	for (int i = 0; i < 2; i ++) {
+		WinxFrameBuffer* buffer = winx->buffers + i;
+		void* pixels = NULL;
+
+		buffer->buffer = winxCreateShmBuffer(width, height, WL_SHM_FORMAT_XRGB8888, &pixels);
+		buffer->pixels = (unsigned int*) pixels;
+		buffer->size = (size_t) width * height * 4;
+		buffer->busy = false;
+
+		if (!buffer->buffer) {
+			winxErrorMsg = (char*) "wl_shm_pool_create_buffer: Failed to create frame buffer!";
+			return false;
+		}
+
+		wl_buffer_add_listener(buffer->buffer, &winxBufferListener, buffer);
+	}
+
+	winx->buffer = 0;
+	return true;
+}
+
+static void winxDeleteFrameBuffers() {
+	for (int i = 0; i < 2; i ++) {
+		WinxFrameBuffer* buffer = winx->buffers + i;
+
+		if (buffer->buffer) {
+			wl_buffer_destroy(buffer->buffer);
+			munmap(buffer->pixels, buffer->size);
+		}
+
+		buffer->buffer = NULL;
+		buffer->pixels = NULL;
+	}
+}
+
+static void winxUpdateMonitors() {
+	free(winx->monitors);
+	winx->monitors = (WinxMonitor*) calloc(winx->output_count, sizeof(WinxMonitor));
+	winx->monitor_count = winx->output_count;
+
+	for (int i = 0; i < winx->output_count; i ++) {
+		winx->monitors[i] = winx->outputs[i].info;
+
+		// wayland has no concept of a primary monitor
+		winx->monitors[i].primary = (i == 0);
+	}
+}
+
+static void winxSetWindowMonitor(int index) {
+	if (index != winx->monitor) {
+		winx->monitor = index;
+		winx->monitor_change(index);
+	}
+}
+
+static WinxOutput* winxGetOutput(struct wl_output* output) {
+	for (int i = 0; i < winx->output_count; i ++) {
+		if (winx->outputs[i].output == output) {
+			return winx->outputs + i;
+		}
+	}
+
+	return NULL;
+}
+
+static void winxOutputGeometry(void* data, struct wl_output* output, int32_t x, int32_t y, int32_t physical_width, int32_t physical_height, int32_t subpixel, const char* make, const char* model, int32_t transform) {
+	WinxOutput* entry = winxGetOutput(output);
+
+	if (entry) {
+		entry->info.x = x;
+		entry->info.y = y;
+
+		if (!entry->info.name[0]) {
+			snprintf(entry->info.name, sizeof(entry->info.name), "%s", model);
+		}
+	}
+}
+
+static void winxOutputMode(void* data, struct wl_output* output, uint32_t flags, int32_t width, int32_t height, int32_t refresh) {
+	WinxOutput* entry = winxGetOutput(output);
+
+	if (entry && (flags & WL_OUTPUT_MODE_CURRENT)) {
+		entry->info.width = width;
+		entry->info.height = height;
+		entry->info.refresh = refresh / 1000.0; // in mHz
+	}
+}
+
+static void winxOutputDone(void* data, struct wl_output* output) {
+	winxUpdateMonitors();
+	winx->monitor_change(winx->monitor);
+}
+
+static void winxOutputScale(void* data, struct wl_output* output, int32_t factor) {}
+
+static void winxOutputName(void* data, struct wl_output* output, const char* name) {
+	WinxOutput* entry = winxGetOutput(output);
+
+	if (entry) {
+		snprintf(entry->info.name, sizeof(entry->info.name), "%s", name);
+	}
+}
+
+static void winxOutputDescription(void* data, struct wl_output* output, const char* description) {}
+
+static const struct wl_output_listener winxOutputListener = {
+	.geometry = winxOutputGeometry,
+	.mode = winxOutputMode,
+	.done = winxOutputDone,
+	.scale = winxOutputScale,
+	.name = winxOutputName,
+	.description = winxOutputDescription
+};
+
+static void winxUpdateEventMask() {
+	// wayland always sends all input events, there is no way to select them
+}
+
+static void winxUpdateCursorState(bool captured, WinxCursor* cursor) {
+	if (!winx->seat_pointer) {
+		return;
+	}
+
+	// pointer capture would need the pointer-constraints protocol, so only the cursor image is updated
+	if (cursor) {
+		wl_surface_attach(winx->cursor_surface, cursor->buffer, 0, 0);
+		wl_surface_damage(winx->cursor_surface, 0, 0, cursor->width, cursor->height);
+		wl_surface_commit(winx->cursor_surface);
+		wl_pointer_set_cursor(winx->seat_pointer, winx->pointer_serial, winx->cursor_surface, cursor->x, cursor->y);
+		return;
+	}
+
+	struct wl_cursor* theme_cursor = winx->cursor_theme ? wl_cursor_theme_get_cursor(winx->cursor_theme, "left_ptr") : NULL;
+
+	if (theme_cursor) {
+		struct wl_cursor_image* image = theme_cursor->images[0];
+
+		wl_surface_attach(winx->cursor_surface, wl_cursor_image_get_buffer(image), 0, 0);
+		wl_surface_damage(winx->cursor_surface, 0, 0, image->width, image->height);
+		wl_surface_commit(winx->cursor_surface);
+		wl_pointer_set_cursor(winx->seat_pointer, winx->pointer_serial, winx->cursor_surface, image->hotspot_x, image->hotspot_y);
+	}
+}
+
+static void winxPointerEnter(void* data, struct wl_pointer* pointer, uint32_t serial, struct wl_surface* surface, wl_fixed_t x, wl_fixed_t y) {
+	winx->pointer_serial = serial;
+	winxUpdateCursorState(winx->capture, winx->cursor_icon);
+}
+
+static void winxPointerLeave(void* data, struct wl_pointer* pointer, uint32_t serial, struct wl_surface* surface) {}
+
+static void winxPointerMotion(void* data, struct wl_pointer* pointer, uint32_t time, wl_fixed_t x, wl_fixed_t y) {
+	WINX_SET_REDRAW(true);
+	winx->cursor(wl_fixed_to_int(x), wl_fixed_to_int(y));
+}
+
+static void winxPointerButton(void* data, struct wl_pointer* pointer, uint32_t serial, uint32_t time, uint32_t button, uint32_t state) {
+	const int type = state == WL_POINTER_BUTTON_STATE_PRESSED ? WINX_PRESSED : WINX_RELEASED;
+	WINX_SET_REDRAW(true);
+
+	switch (button) {
+		case BTN_LEFT: winx->button(type, WXB_LEFT); break;
+		case BTN_MIDDLE: winx->button(type, WXB_CENTER); break;
+		case BTN_RIGHT: winx->button(type, WXB_RIGHT); break;
+	}
+}
+
+static void winxPointerAxis(void* data, struct wl_pointer* pointer, uint32_t time, uint32_t axis, wl_fixed_t value) {
+	if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL && value != 0) {
+		WINX_SET_REDRAW(true);
+		winx->scroll(value < 0 ? 1 : -1);
+	}
+}
+
+static const struct wl_pointer_listener winxPointerListener = {
+	.enter = winxPointerEnter,
+	.leave = winxPointerLeave,
+	.motion = winxPointerMotion,
+	.button = winxPointerButton,
+	.axis = winxPointerAxis
+};
+
+// keysyms are shared with X11, so the WXK_* keys work the same way, this matches what XLookupKeysym() returns
+static int winxGetKeysym(uint32_t key) {
+	const xkb_keysym_t* keysyms;
+
+	// evdev key codes are offset by 8 from the XKB key codes
+	if (winx->keymap && xkb_keymap_key_get_syms_by_level(winx->keymap, key + 8, 0, 0, &keysyms) > 0) {
+		return keysyms[0];
+	}
+
+	return 0;
+}
+
+static void winxKeyboardKeymap(void* data, struct wl_keyboard* keyboard, uint32_t format, int32_t fd, uint32_t size) {
+	if (format != WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1) {
+		close(fd);
+		return;
+	}
+
+	char* map = (char*) mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (map == MAP_FAILED) {
+		return;
+	}
+
+	xkb_keymap_unref(winx->keymap);
+	winx->keymap = xkb_keymap_new_from_string(winx->xkb, map, XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
+	munmap(map, size);
+}
+
+static void winxKeyboardEnter(void* data, struct wl_keyboard* keyboard, uint32_t serial, struct wl_surface* surface, struct wl_array* keys) {}
+
+static void winxKeyboardLeave(void* data, struct wl_keyboard* keyboard, uint32_t serial, struct wl_surface* surface) {
+	winx->repeat_key = -1;
+}
+
+static void winxKeyboardKey(void* data, struct wl_keyboard* keyboard, uint32_t serial, uint32_t time, uint32_t key, uint32_t state) {
+	WINX_SET_REDRAW(true);
+
+	if (state == WL_KEYBOARD_KEY_STATE_PRESSED) {
+		winx->keyboard(WINX_PRESSED, winxGetKeysym(key));
+
+		// the compositor doesn't send repeated key events, winxProcessEvents() generates them
+		if (winx->keymap && winx->repeat_rate > 0 && xkb_keymap_key_repeats(winx->keymap, key + 8)) {
+			winx->repeat_key = key;
+			winx->repeat_time = winxGetTime() + winx->repeat_delay / 1000.0;
+		}
+
+		return;
+	}
+
+	if ((int) key == winx->repeat_key) {
+		winx->repeat_key = -1;
+	}
+
+	winx->keyboard(WINX_RELEASED, winxGetKeysym(key));
+}
+
+static void winxKeyboardModifiers(void* data, struct wl_keyboard* keyboard, uint32_t serial, uint32_t depressed, uint32_t latched, uint32_t locked, uint32_t group) {}
+
+static void winxKeyboardRepeatInfo(void* data, struct wl_keyboard* keyboard, int32_t rate, int32_t delay) {
+	winx->repeat_rate = rate;
+	winx->repeat_delay = delay;
+}
+
+static const struct wl_keyboard_listener winxKeyboardListener = {
+	.keymap = winxKeyboardKeymap,
+	.enter = winxKeyboardEnter,
+	.leave = winxKeyboardLeave,
+	.key = winxKeyboardKey,
+	.modifiers = winxKeyboardModifiers,
+	.repeat_info = winxKeyboardRepeatInfo
+};
+
+static void winxSeatCapabilities(void* data, struct wl_seat* seat, uint32_t capabilities) {
+	if ((capabilities & WL_SEAT_CAPABILITY_POINTER) && !winx->seat_pointer) {
+		winx->seat_pointer = wl_seat_get_pointer(seat);
+		wl_pointer_add_listener(winx->seat_pointer, &winxPointerListener, NULL);
+	}
+
+	if ((capabilities & WL_SEAT_CAPABILITY_KEYBOARD) && !winx->seat_keyboard) {
+		winx->seat_keyboard = wl_seat_get_keyboard(seat);
+		wl_keyboard_add_listener(winx->seat_keyboard, &winxKeyboardListener, NULL);
+	}
+}
+
+static void winxSeatName(void* data, struct wl_seat* seat, const char* name) {}
+
+static const struct wl_seat_listener winxSeatListener = {
+	.capabilities = winxSeatCapabilities,
+	.name = winxSeatName
+};
+
+static void winxWmBasePing(void* data, struct xdg_wm_base* wm_base, uint32_t serial) {
+	xdg_wm_base_pong(wm_base, serial);
+}
+
+static const struct xdg_wm_base_listener winxWmBaseListener = {
+	.ping = winxWmBasePing
+};
+
+static void winxPresentationClock(void* data, struct wp_presentation* presentation, uint32_t clock) {
+	winx->presentation_clock = (clockid_t) clock;
+}
+
+static const struct wp_presentation_listener winxPresentationListener = {
+	.clock_id = winxPresentationClock
+};
+
+static void winxFeedbackSyncOutput(void* data, struct wp_presentation_feedback* feedback, struct wl_output* output) {}
+
+static void winxFeedbackPresented(void* data, struct wp_presentation_feedback* feedback, uint32_t seconds_high, uint32_t seconds_low, uint32_t nanoseconds, uint32_t refresh, uint32_t sequence_high, uint32_t sequence_low, uint32_t flags) {
+	struct timespec now;
+	clock_gettime(winx->presentation_clock, &now);
+
+	// convert the timestamp from the presentation clock to the winxGetTime() clock
+	const double presented = (double) (((uint64_t) seconds_high << 32) | seconds_low) + nanoseconds / 1e+9;
+	const double current = (double) now.tv_sec + now.tv_nsec / 1e+9;
+
+	winx->presented = true;
+	winx->present_time = winxGetTime() - (current - presented);
+	winx->present_interval = refresh / 1e+9;
+
+	wp_presentation_feedback_destroy(feedback);
+}
+
+static void winxFeedbackDiscarded(void* data, struct wp_presentation_feedback* feedback) {
+	wp_presentation_feedback_destroy(feedback);
+}
+
+static const struct wp_presentation_feedback_listener winxFeedbackListener = {
+	.sync_output = winxFeedbackSyncOutput,
+	.presented = winxFeedbackPresented,
+	.discarded = winxFeedbackDiscarded
+};
+
+static void winxRegistryGlobal(void* data, struct wl_registry* registry, uint32_t name, const char* interface, uint32_t version) {
+	#define WINX_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+	if (strcmp(interface, wl_compositor_interface.name) == 0) {
+		winx->compositor = (struct wl_compositor*) wl_registry_bind(registry, name, &wl_compositor_interface, WINX_MIN(version, 4));
+	}
+
+	if (strcmp(interface, wl_shm_interface.name) == 0) {
+		winx->shm = (struct wl_shm*) wl_registry_bind(registry, name, &wl_shm_interface, 1);
+	}
+
+	// version 5 adds pointer frame events, which are not needed
+	if (strcmp(interface, wl_seat_interface.name) == 0 && !winx->seat) {
+		winx->seat = (struct wl_seat*) wl_registry_bind(registry, name, &wl_seat_interface, WINX_MIN(version, 4));
+		wl_seat_add_listener(winx->seat, &winxSeatListener, NULL);
+	}
+
+	if (strcmp(interface, xdg_wm_base_interface.name) == 0) {
+		winx->wm_base = (struct xdg_wm_base*) wl_registry_bind(registry, name, &xdg_wm_base_interface, WINX_MIN(version, WINX_XDG_VERSION));
+		xdg_wm_base_add_listener(winx->wm_base, &winxWmBaseListener, NULL);
+	}
+
+	if (strcmp(interface, wp_presentation_interface.name) == 0) {
+		winx->presentation = (struct wp_presentation*) wl_registry_bind(registry, name, &wp_presentation_interface, 1);
+		wp_presentation_add_listener(winx->presentation, &winxPresentationListener, NULL);
+	}
+
+	if (strcmp(interface, wl_output_interface.name) == 0) {
+		winx->outputs = (WinxOutput*) realloc(winx->outputs, (winx->output_count + 1) * sizeof(WinxOutput));
+
+		WinxOutput* entry = winx->outputs + (winx->output_count ++);
+		memset(entry, 0, sizeof(WinxOutput));
+		entry->name = name;
+		entry->output = (struct wl_output*) wl_registry_bind(registry, name, &wl_output_interface, WINX_MIN(version, 4));
+		wl_output_add_listener(entry->output, &winxOutputListener, NULL);
+	}
+
+	#undef WINX_MIN
+}
+
+static void winxRegistryGlobalRemove(void* data, struct wl_registry* registry, uint32_t name) {
+	for (int i = 0; i < winx->output_count; i ++) {
+		if (winx->outputs[i].name == name) {
+			wl_output_destroy(winx->outputs[i].output);
+			memmove(winx->outputs + i, winx->outputs + i + 1, (winx->output_count - i - 1) * sizeof(WinxOutput));
+			winx->output_count --;
+
+			winxUpdateMonitors();
+			winxSetWindowMonitor(0);
+			return;
+		}
+	}
+}
+
+static const struct wl_registry_listener winxRegistryListener = {
+	.global = winxRegistryGlobal,
+	.global_remove = winxRegistryGlobalRemove
+};
+
+static void winxSurfaceEnter(void* data, struct wl_surface* surface, struct wl_output* output) {
+	WinxOutput* entry = winxGetOutput(output);
+
+	if (entry) {
+		winxSetWindowMonitor(entry - winx->outputs);
+	}
+}
+
+static void winxSurfaceLeave(void* data, struct wl_surface* surface, struct wl_output* output) {}
+
+static const struct wl_surface_listener winxSurfaceListener = {
+	.enter = winxSurfaceEnter,
+	.leave = winxSurfaceLeave
+};
+
+static void winxToplevelConfigure(void* data, struct xdg_toplevel* toplevel, int32_t width, int32_t height, struct wl_array* states) {
+	uint32_t* state;
+
+	// zero means that the size is up to the client
+	winx->pending_width = width ? width : winx->width;
+	winx->pending_height = height ? height : winx->height;
+	winx->pending_focused = false;
+	winx->pending_hidden = false;
+
+	wl_array_for_each(state, states) {
+		if (*state == XDG_TOPLEVEL_STATE_ACTIVATED) {
+			winx->pending_focused = true;
+		}
+
+#if defined(XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION)
+		if (*state == XDG_TOPLEVEL_STATE_SUSPENDED) {
+			winx->pending_hidden = true;
+		}
+#endif
+	}
+}
+
+static void winxToplevelClose(void* data, struct xdg_toplevel* toplevel) {
+	WINX_SET_REDRAW(true); // wake up the lazy event loop
+	winx->close();
+}
+
+#if defined(XDG_TOPLEVEL_CONFIGURE_BOUNDS_SINCE_VERSION)
+static void winxToplevelConfigureBounds(void* data, struct xdg_toplevel* toplevel, int32_t width, int32_t height) {}
+#endif
+
+#if defined(XDG_TOPLEVEL_WM_CAPABILITIES_SINCE_VERSION)
+static void winxToplevelCapabilities(void* data, struct xdg_toplevel* toplevel, struct wl_array* capabilities) {}
+#endif
+
+static const struct xdg_toplevel_listener winxToplevelListener = {
+	.configure = winxToplevelConfigure,
+	.close = winxToplevelClose,
+#if defined(XDG_TOPLEVEL_CONFIGURE_BOUNDS_SINCE_VERSION)
+	.configure_bounds = winxToplevelConfigureBounds,
+#endif
+#if defined(XDG_TOPLEVEL_WM_CAPABILITIES_SINCE_VERSION)
+	.wm_capabilities = winxToplevelCapabilities,
+#endif
+};
+
+// the EGL config has alpha bits for the application to use, don't let the compositor blend the window with what is behind it
+static void winxUpdateOpaqueRegion() {
+	struct wl_region* region = wl_compositor_create_region(winx->compositor);
+	wl_region_add(region, 0, 0, winx->width, winx->height);
+	wl_surface_set_opaque_region(winx->surface, region);
+	wl_region_destroy(region);
+}
+
+// the xdg_toplevel configure events are only applied once the whole configure sequence is done
+static void winxSurfaceConfigure(void* data, struct xdg_surface* surface, uint32_t serial) {
+	xdg_surface_ack_configure(surface, serial);
+
+	if (winx->pending_width != winx->width || winx->pending_height != winx->height) {
+		winx->width = winx->pending_width;
+		winx->height = winx->pending_height;
+
+		if (winx->egl_window) {
+			wl_egl_window_resize(winx->egl_window, winx->width, winx->height, 0, 0);
+			winxUpdateOpaqueRegion();
+		}
+
+		// the first configure comes before winxOpen() creates the buffers, on failure
+		// leave no half created buffers behind, winxGetPixels() returns NULL until the next resize
+		if (winx->mode == WINX_CONTEXT_SOFTWARE && winx->configured) {
+			winxDeleteFrameBuffers();
+
+			if (!winxCreateFrameBuffers(winx->width, winx->height)) {
+				winxDeleteFrameBuffers();
+			}
+		}
+
+		winx->resize(winx->width, winx->height);
+	}
+
+	if (winx->pending_focused != winx->focused) {
+		winx->focused = winx->pending_focused;
+		winx->focus(winx->focused);
+	}
+
+	// wayland has no expose events, the compositor only asks for a new frame when configuring the window
+	winx->configured = true;
+	winx->mapped = true;
+	winx->hidden = winx->pending_hidden;
+	WINX_SET_REDRAW(true);
+
+	winxUpdateVisibility();
+	winx->expose(0, 0, winx->width, winx->height);
+}
+
+static const struct xdg_surface_listener winxXdgSurfaceListener = {
+	.configure = winxSurfaceConfigure
+};
+
+static bool winxCreateContext() {
+	winx->egl_display = eglGetDisplay((EGLNativeDisplayType) winx->display);
+
+	if (winx->egl_display == EGL_NO_DISPLAY || !eglInitialize(winx->egl_display, NULL, NULL)) {
+		winxErrorMsg = (char*) "eglInitialize: Failed to initialize EGL display!";
+		return false;
+	}
+
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		winxErrorMsg = (char*) "eglBindAPI: Failed to bind the OpenGL API!";
+		return false;
+	}
+
+	EGLint attributes[] = {
+		EGL_SURFACE_TYPE, EGL_WINDOW_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, __winx_hint_red_bits,
+		EGL_GREEN_SIZE, __winx_hint_green_bits,
+		EGL_BLUE_SIZE, __winx_hint_blue_bits,
+		EGL_ALPHA_SIZE, __winx_hint_alpha_bits,
+		EGL_DEPTH_SIZE, __winx_hint_depth_bits,
+		EGL_STENCIL_SIZE, __winx_hint_stencil_bits,
+		EGL_SAMPLE_BUFFERS, __winx_hint_multisamples ? 1 : 0,
+		EGL_SAMPLES, __winx_hint_multisamples,
+		EGL_NONE
+	};
+
+	// the preserved back buffer is only needed for partial presentation, so try without it if there is no such config
+	EGLConfig config;
+	EGLint count = 0;
+	eglChooseConfig(winx->egl_display, attributes, &config, 1, &count);
+
+	if (!count) {
+		attributes[1] = EGL_WINDOW_BIT;
+		eglChooseConfig(winx->egl_display, attributes, &config, 1, &count);
+	}
+
+	if (!count) {
+		winxErrorMsg = (char*) "eglChooseConfig: Failed to choose a frame buffer config!";
+		return false;
+	}
+
+	int flags = 0;
+
+	if (__winx_hint_opengl_debug) flags |= EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR;
+	if (__winx_hint_opengl_robust) flags |= EGL_CONTEXT_OPENGL_ROBUST_ACCESS_BIT_KHR;
+
+	EGLint context_attributes[16] = {
+		EGL_CONTEXT_MAJOR_VERSION_KHR, __winx_hint_opengl_major,
+		EGL_CONTEXT_MINOR_VERSION_KHR, __winx_hint_opengl_minor,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, __winx_hint_opengl_core ? EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR : EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR,
+		EGL_CONTEXT_FLAGS_KHR, flags,
+		EGL_NONE
+	};
+
+	// the optional attributes go at the end, so that they can be cut off if the context can't be created with them
+	const char* extensions = eglQueryString(winx->egl_display, EGL_EXTENSIONS);
+	const int required = 8;
+	int length = required;
+
+	// a no-error context can't also be a debug or robust one
+	winx->no_error = __winx_hint_opengl_no_error && !flags && winxHasToken(extensions, "EGL_KHR_create_context_no_error");
+	winx->release_none = __winx_hint_opengl_release == WINX_RELEASE_NONE && winxHasToken(extensions, "EGL_KHR_context_flush_control");
+
+	if (winx->no_error) {
+		context_attributes[length ++] = EGL_CONTEXT_OPENGL_NO_ERROR_KHR;
+		context_attributes[length ++] = EGL_TRUE;
+	}
+
+	if (winx->release_none) {
+		context_attributes[length ++] = EGL_CONTEXT_RELEASE_BEHAVIOR_KHR;
+		context_attributes[length ++] = EGL_CONTEXT_RELEASE_BEHAVIOR_NONE_KHR;
+	}
+
+	context_attributes[length] = EGL_NONE;
+	winx->context = eglCreateContext(winx->egl_display, config, EGL_NO_CONTEXT, context_attributes);
+
+	if (winx->context == EGL_NO_CONTEXT && length != required) {
+		winx->no_error = false;
+		winx->release_none = false;
+		context_attributes[required] = EGL_NONE;
+
+		winx->context = eglCreateContext(winx->egl_display, config, EGL_NO_CONTEXT, context_attributes);
+	}
+
+	if (winx->context == EGL_NO_CONTEXT) {
+		winxErrorMsg = (char*) "eglCreateContext: Failed to create context";
+		return false;
+	}
+
+	// in EGL the color space belongs to the surface, not the config
+	const EGLint surface_attributes[] = {
+		EGL_GL_COLORSPACE_KHR, EGL_GL_COLORSPACE_SRGB_KHR,
+		EGL_NONE
+	};
+
+	winx->egl_window = wl_egl_window_create(winx->surface, winx->width, winx->height);
+	winxUpdateOpaqueRegion();
+	winx->egl_surface = EGL_NO_SURFACE;
+	winx->srgb = __winx_hint_srgb && winxHasToken(extensions, "EGL_KHR_gl_colorspace");
+
+	if (winx->srgb) {
+		winx->egl_surface = eglCreateWindowSurface(winx->egl_display, config, (EGLNativeWindowType) winx->egl_window, surface_attributes);
+		winx->srgb = winx->egl_surface != EGL_NO_SURFACE;
+	}
+
+	if (winx->egl_surface == EGL_NO_SURFACE) {
+		winx->egl_surface = eglCreateWindowSurface(winx->egl_display, config, (EGLNativeWindowType) winx->egl_window, NULL);
+	}
+
+	if (winx->egl_surface == EGL_NO_SURFACE) {
+		winxErrorMsg = (char*) "eglCreateWindowSurface: Failed to create window surface!";
+		return false;
+	}
+
+	// partial presentation needs both a preserved back buffer and a way to tell the compositor what changed
+	winx->preserved = attributes[1] != EGL_WINDOW_BIT && eglSurfaceAttrib(winx->egl_display, winx->egl_surface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED);
+
+	if (winxHasToken(extensions, "EGL_KHR_swap_buffers_with_damage")) {
+		winx->eglSwapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC) eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+	} else if (winxHasToken(extensions, "EGL_EXT_swap_buffers_with_damage")) {
+		winx->eglSwapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC) eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+	}
+
+	eglMakeCurrent(winx->egl_display, winx->egl_surface, winx->egl_surface, winx->context);
+	winxInitGL();
+
+	return true;
+}
+
+bool winxOpen(int width, int height, const char* title) {
+	winx = (WinxHandle*) calloc(1, sizeof(WinxHandle));
+	winx->capture = false;
+	winx->lazy = __winx_hint_lazy;
+	WINX_SET_REDRAW(true);
+	winx->throttle = __winx_hint_throttle;
+	winx->mode = __winx_hint_context;
+	winx->width = width;
+	winx->height = height;
+	winx->repeat_key = -1;
+	winx->presentation_clock = CLOCK_MONOTONIC;
+
+	struct timespec spec;
+	clock_gettime(CLOCK_MONOTONIC, &spec);
+	winx->time = spec.tv_sec;
+
+	// set dummy function pointers
+	winxResetEventHandles();
+
+	winx->display = wl_display_connect(NULL);
+	if (!winx->display) {
+		winxErrorMsg = (char*) "wl_display_connect: Failed to connect to the Wayland display!";
+		winxClose();
+		return false;
+	}
+
+	// the first round trip collects the globals, the second one the initial events of the bound objects
+	winx->registry = wl_display_get_registry(winx->display);
+	wl_registry_add_listener(winx->registry, &winxRegistryListener, NULL);
+	wl_display_roundtrip(winx->display);
+
+	if (!winx->compositor || !winx->wm_base || !winx->shm) {
+		winxErrorMsg = (char*) "wl_registry: Compositor doesn't support xdg_shell!";
+		winxClose();
+		return false;
+	}
+
+	winx->xkb = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+	wl_display_roundtrip(winx->display);
+
+	winx->cursor_theme = wl_cursor_theme_load(NULL, 24, winx->shm);
+	winx->cursor_surface = wl_compositor_create_surface(winx->compositor);
+
+	winx->surface = wl_compositor_create_surface(winx->compositor);
+	wl_surface_add_listener(winx->surface, &winxSurfaceListener, NULL);
+
+	winx->xdg_surface = xdg_wm_base_get_xdg_surface(winx->wm_base, winx->surface);
+	xdg_surface_add_listener(winx->xdg_surface, &winxXdgSurfaceListener, NULL);
+
+	winx->toplevel = xdg_surface_get_toplevel(winx->xdg_surface);
+	xdg_toplevel_add_listener(winx->toplevel, &winxToplevelListener, NULL);
+	winxSetTitle(title);
+
+	// the surface can only be drawn to after the first configure event
+	wl_surface_commit(winx->surface);
+
+	while (!winx->configured) {
+		if (wl_display_dispatch(winx->display) == -1) {
+			winxErrorMsg = (char*) "wl_display_dispatch: Lost connection to the Wayland display!";
+			winxClose();
+			return false;
+		}
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		if (!winxCreateFrameBuffers(winx->width, winx->height)) {
+			winxClose();
+			return false;
+		}
+	} else if (winx->mode == WINX_CONTEXT_OPENGL) {
+		if (!winxCreateContext()) {
+			winxClose();
+			return false;
+		}
+	}
+
+	winxUpdateMonitors();
+	winxSetVsync(__winx_hint_vsync);
+
+	return true;
+}
+
+// read the events that already arrived, or wait for them up to the timeout (in milliseconds, -1 for no limit),
+// this is the way of reading events that doesn't race with other threads using the same display
+static void winxReadEvents(int timeout) {
+	while (wl_display_prepare_read(winx->display) != 0) {
+		wl_display_dispatch_pending(winx->display);
+	}
+
+	wl_display_flush(winx->display);
+
+	if (winxPollSources(wl_display_get_fd(winx->display), timeout)) {
+		wl_display_read_events(winx->display);
+	} else {
+		wl_display_cancel_read(winx->display);
+	}
+}
+
+static void winxWaitForEvents() {
+	int timeout = -1;
+
+	// wake up for the next generated key repeat
+	if (winx->repeat_key != -1) {
+		const double wait = winx->repeat_time - winxGetTime();
+		timeout = wait > 0 ? (int) (wait * 1000) + 1 : 0;
+	}
+
+	winxReadEvents(timeout);
+}
+
+static void winxProcessEvents() {
+	winxReadEvents(0);
+
+	// the event handles could call winxClose(), which has to wait until all events are dispatched
+	winx->dispatching = true;
+	wl_display_dispatch_pending(winx->display);
+	winx->dispatching = false;
+
+	if (winx->closing) {
+		winxClose();
+		return;
+	}
+
+	if (winx->repeat_key != -1 && winxGetTime() >= winx->repeat_time) {
+		winx->repeat_time += 1.0 / winx->repeat_rate;
+		WINX_SET_REDRAW(true);
+		winx->keyboard(WINX_REPEATED, winxGetKeysym(winx->repeat_key));
+	}
+
+	winxDispatchSources();
+}
+
+void winxPollEvents() {
+	winxProcessEvents();
+
+	// in lazy mode block until there is something to redraw
+	while (winx && winx->lazy && !WINX_GET_REDRAW()) {
+		winxWaitForEvents();
+		winxProcessEvents();
+	}
+}
+
+void winxWaitEvents() {
+	winxWaitForEvents();
+	winxProcessEvents();
+}
+
+void winxMakeContextCurrent() {
+	WINX_CONTEXT_ASSERT("winxMakeContextCurrent");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxMakeContextCurrent: Current window has no OpenGL context!";
+		return;
+	}
+
+	if (!eglMakeCurrent(winx->egl_display, winx->egl_surface, winx->egl_surface, winx->context)) {
+		winxErrorMsg = (char*) "eglMakeCurrent: Failed to make context current!";
+	}
+}
+
+void winxReleaseContext() {
+	WINX_CONTEXT_ASSERT("winxReleaseContext");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		return;
+	}
+
+	eglMakeCurrent(winx->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+}
+
+// ask the compositor when the next committed frame is actually shown
+static void winxRequestFeedback() {
+	if (winx->presentation) {
+		struct wp_presentation_feedback* feedback = wp_presentation_feedback(winx->presentation, winx->surface);
+		wp_presentation_feedback_add_listener(feedback, &winxFeedbackListener, NULL);
+	}
+}
+
+void winxSwapBuffers() {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxPresentPixels(NULL, 0);
+		return;
+	}
+
+	// the frame was presented by Vulkan
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	winxEndFrame();
+	winxRequestFeedback();
+	eglSwapBuffers(winx->egl_display, winx->egl_surface);
+}
+
+void winxSwapBuffersWithDamage(const int* rects, int count) {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxPresentPixels(rects, count);
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	winxEndFrame();
+	winxRequestFeedback();
+
+	if (!winx->eglSwapBuffersWithDamage || !rects || count <= 0) {
+		eglSwapBuffers(winx->egl_display, winx->egl_surface);
+		return;
+	}
+
+	// EGL expects the origin to be in the bottom-left corner
+	EGLint* damage = (EGLint*) malloc(count * 4 * sizeof(EGLint));
+
+	for (int i = 0; i < count * 4; i += 4) {
+		damage[i + 0] = rects[i + 0];
+		damage[i + 1] = winx->height - rects[i + 1] - rects[i + 3];
+		damage[i + 2] = rects[i + 2];
+		damage[i + 3] = rects[i + 3];
+	}
+
+	winx->eglSwapBuffersWithDamage(winx->egl_display, winx->egl_surface, damage, count);
+	free(damage);
+}
+
+bool winxGetDamageSupport() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetDamageSupport: No active winx context!";
+		return false;
+	}
+
+	return winx->mode == WINX_CONTEXT_SOFTWARE || (winx->eglSwapBuffersWithDamage && winx->preserved);
+}
+
+const WinxInputSample* winxGetInputSamples(int* count) {
+	// touch and tablet input would need wl_touch and the tablet protocol, which are not bound yet
+	*count = 0;
+	return NULL;
+}
+
+bool winxGetPresentTiming(double* time, double* interval) {
+	if (!winx || !winx->presented) {
+		*time = 0;
+		*interval = 0;
+		return false;
+	}
+
+	*time = winx->present_time;
+	*interval = winx->present_interval;
+	return true;
+}
+
+unsigned int* winxGetPixels() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetPixels: No active winx context!";
+		return NULL;
+	}
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxGetPixels: Current window is not a software window!";
+		return NULL;
+	}
+
+	if (!winx->buffers[winx->buffer].buffer) {
+		winxErrorMsg = (char*) "winxGetPixels: Failed to create frame buffer!";
+		return NULL;
+	}
+
+	return winx->buffers[winx->buffer].pixels;
+}
+
+void winxPresentPixels(const int* rects, int count) {
+	WINX_CONTEXT_ASSERT("winxPresentPixels");
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxPresentPixels: Current window is not a software window!";
+		return;
+	}
+
+	WinxFrameBuffer* front = winx->buffers + winx->buffer;
+	WinxFrameBuffer* back = winx->buffers + (winx->buffer ^ 1);
+
+	if (!front->buffer) {
+		winxErrorMsg = (char*) "winxPresentPixels: Failed to create frame buffer!";
+		return;
+	}
+
+	wl_surface_attach(winx->surface, front->buffer, 0, 0);
+
+	if (!rects || count <= 0) {
+		wl_surface_damage_buffer(winx->surface, 0, 0, winx->width, winx->height);
+	} else {
+		for (int i = 0; i < count * 4; i += 4) {
+			wl_surface_damage_buffer(winx->surface, rects[i + 0], rects[i + 1], rects[i + 2], rects[i + 3]);
+		}
+	}
+
+	winxRequestFeedback();
+	wl_surface_commit(winx->surface);
+	front->busy = true;
+
+	// the compositor releases the buffer once it no longer reads from it
+	winx->dispatching = true;
+	while (back->busy && wl_display_dispatch(winx->display) != -1);
+	winx->dispatching = false;
+
+	// keep the previous frame in the new back buffer, so that only the damaged parts need to be redrawn
+	memcpy(back->pixels, front->pixels, front->size);
+	winx->buffer ^= 1;
+}
+
+void winxClose() {
+	if (winx->dispatching) {
+		winx->closing = true;
+		return;
+	}
+
+	winxFreeSources();
+	winxFreeCursors();
+
+	// also used when winxOpen() failed, so any of the objects below could be missing
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxDeleteFrameBuffers();
+	} else if (winx->egl_display != EGL_NO_DISPLAY) {
+		// the render thread has released the context, take it back to free the objects created in it
+		if (winx->context != EGL_NO_CONTEXT && winx->egl_surface != EGL_NO_SURFACE) {
+			eglMakeCurrent(winx->egl_display, winx->egl_surface, winx->egl_surface, winx->context);
+			winxFreeGL();
+		}
+
+		eglMakeCurrent(winx->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (winx->egl_surface != EGL_NO_SURFACE) eglDestroySurface(winx->egl_display, winx->egl_surface);
+		if (winx->context != EGL_NO_CONTEXT) eglDestroyContext(winx->egl_display, winx->context);
+		if (winx->egl_window) wl_egl_window_destroy(winx->egl_window);
+		eglTerminate(winx->egl_display);
+	}
+
+	if (winx->toplevel) xdg_toplevel_destroy(winx->toplevel);
+	if (winx->xdg_surface) xdg_surface_destroy(winx->xdg_surface);
+	if (winx->surface) wl_surface_destroy(winx->surface);
+	if (winx->cursor_surface) wl_surface_destroy(winx->cursor_surface);
+
+	if (winx->cursor_theme) wl_cursor_theme_destroy(winx->cursor_theme);
+	if (winx->seat_pointer) wl_pointer_destroy(winx->seat_pointer);
+	if (winx->seat_keyboard) wl_keyboard_destroy(winx->seat_keyboard);
+	if (winx->presentation) wp_presentation_destroy(winx->presentation);
+
+	// the globals only die with the connection on the server side, but their proxies still need to be freed
+	if (winx->seat) wl_seat_destroy(winx->seat);
+	if (winx->shm) wl_shm_destroy(winx->shm);
+	if (winx->wm_base) xdg_wm_base_destroy(winx->wm_base);
+	if (winx->compositor) wl_compositor_destroy(winx->compositor);
+	if (winx->registry) wl_registry_destroy(winx->registry);
+
+	for (int i = 0; i < winx->output_count; i ++) {
+		wl_output_destroy(winx->outputs[i].output);
+	}
+
+	xkb_keymap_unref(winx->keymap);
+	xkb_context_unref(winx->xkb);
+
+	if (winx->display) {
+		wl_display_disconnect(winx->display);
+	}
+
+	free(winx->outputs);
+	free(winx->monitors);
+	free(winx);
+	winx = NULL;
+}
+
+void winxTerminate() {
+	// the wayland connection is cheap to reopen, the WINX_HINT_PERSISTENT hint is ignored
+}
+
+void* winxGetProcAddress(const char* name) {
+	return (void*) eglGetProcAddress(name);
+}
+
+// the Vulkan loader is only opened when it's needed, so that winx doesn't depend on it
+static bool winxLoadVulkan() {
+	if (!vkGetInstanceProcAddr) {
+		void* library = dlopen("libvulkan.so.1", RTLD_NOW | RTLD_LOCAL);
+
+		if (!library) {
+			library = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+		}
+
+		if (!library) {
+			winxErrorMsg = (char*) "dlopen: Failed to load the Vulkan loader!";
+			return false;
+		}
+
+		vkGetInstanceProcAddr = (PFNVKGETINSTANCEPROCADDRPROC) dlsym(library, "vkGetInstanceProcAddr");
+	}
+
+	return vkGetInstanceProcAddr != NULL;
+}
+
+const char** winxGetRequiredVulkanInstanceExtensions(int* count) {
+	static const char* extensions[] = {"VK_KHR_surface", "VK_KHR_wayland_surface"};
+
+	if (!winxLoadVulkan()) {
+		*count = 0;
+		return NULL;
+	}
+
+	*count = 2;
+	return extensions;
+}
+
+bool winxCreateVulkanSurface(void* instance, const void* allocator, void* surface) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: No active winx context!";
+		return false;
+	}
+
+	if (!winxLoadVulkan()) {
+		return false;
+	}
+
+	PFNVKCREATEWAYLANDSURFACEKHRPROC vkCreateWaylandSurfaceKHR = (PFNVKCREATEWAYLANDSURFACEKHRPROC) vkGetInstanceProcAddr(instance, "vkCreateWaylandSurfaceKHR");
+
+	if (!vkCreateWaylandSurfaceKHR) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: Instance was created without VK_KHR_wayland_surface!";
+		return false;
+	}
+
+	VkWaylandSurfaceCreateInfoKHR info = {VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR, NULL, 0, winx->display, winx->surface};
+
+	if (vkCreateWaylandSurfaceKHR(instance, &info, allocator, surface) != 0) {
+		winxErrorMsg = (char*) "vkCreateWaylandSurfaceKHR: Failed to create surface!";
+		return false;
+	}
+
+	return true;
+}
+
+void winxSetTitle(const char* title) {
+	WINX_CONTEXT_ASSERT("winxSetTitle");
+
+	xdg_toplevel_set_title(winx->toplevel, title);
+}
+
+void winxSetIcon(int width, int height, unsigned char* buffer) {
+	WINX_CONTEXT_ASSERT("winxSetIcon");
+
+	// xdg_shell has no way of setting the window icon, compositors use the icon of the application's desktop file
+}
+
+void winxSetFullscreen(bool fullscreen) {
+	WINX_CONTEXT_ASSERT("winxSetFullscreen");
+
+	// wayland compositors scan out fullscreen surfaces directly when they can
+	if (fullscreen) {
+		xdg_toplevel_set_fullscreen(winx->toplevel, NULL);
+	} else {
+		xdg_toplevel_unset_fullscreen(winx->toplevel);
+	}
+
+	wl_display_flush(winx->display);
+}
+
+WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, int x, int y) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateCursorIcon: No active winx context!";
+		return NULL;
+	}
+
+	void* memory;
+	struct wl_buffer* native = winxCreateShmBuffer(width, height, WL_SHM_FORMAT_ARGB8888, &memory);
+
+	if (!native) {
+		winxErrorMsg = (char*) "wl_shm_pool_create_buffer: Failed to create cursor image!";
+		return NULL;
+	}
+
+	// wayland expects premultiplied alpha
+	unsigned int* pixels = (unsigned int*) memory;
+
+	for (int i = 0, j = 0; i < width * height * 4; i += 4) {
+		const unsigned int alpha = buffer[i + 3];
+		pixels[j ++] = (buffer[i + 2] * alpha / 255) | (buffer[i + 1] * alpha / 255) << 8 | (buffer[i + 0] * alpha / 255) << 16 | alpha << 24;
+	}
+
+	munmap(memory, (size_t) width * height * 4);
+
+	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
+	cursor->buffer = native;
+	cursor->width = width;
+	cursor->height = height;
+	cursor->x = x;
+	cursor->y = y;
+	winxTrackCursor(cursor);
+
+	return cursor;
+}
+
+WinxCursor* winxCreateNullCursorIcon() {
+	unsigned char pixels[1 * 1 * 4] = {0, 0, 0, 0};
+	return winxCreateCursorIcon(1, 1, pixels, 0, 0);
+}
+
+void winxDeleteCursorIcon(WinxCursor* cursor) {
+	WINX_CONTEXT_ASSERT("winxDeleteCursorIcon");
+
+	if (cursor && winxUntrackCursor(cursor)) {
+		wl_buffer_destroy(cursor->buffer);
+		free(cursor);
+	}
+}
+
+void winxSetVsync(int vsync) {
+	WINX_CONTEXT_ASSERT("winxSetVsync");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		return;
+	}
+
+	// with a swap interval of 1 EGL waits for the compositor's frame callbacks
+	eglSwapInterval(winx->egl_display, vsync == WINX_VSYNC_ADAPTIVE ? WINX_VSYNC_ENABLED : vsync);
+}
+
+void winxSetFocus() {
+	WINX_CONTEXT_ASSERT("winxSetFocus");
+
+	// focus stealing is not allowed on wayland without the xdg_activation protocol
+}
+
+void winxSetCursorPos(int x, int y) {
+	WINX_CONTEXT_ASSERT("winxSetCursorPos");
+
+	// wayland clients can't move the pointer
+}
+
+void* winxGetNativeDisplay() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeDisplay: No active winx context!";
+		return NULL;
+	}
+
+	return winx->display;
+}
+
+void* winxGetNativeWindow() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeWindow: No active winx context!";
+		return NULL;
+	}
+
+	return winx->surface;
+}
+
+double winxGetTime() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetTime: No active winx context!";
+		return 0;
+	}
+
+	struct timespec spec;
+	clock_gettime(CLOCK_MONOTONIC, &spec);
+	return (spec.tv_sec - winx->time) + (spec.tv_nsec / (double) 1e+9);
+}
+
+#endif // WAYLAND
+
+#if defined(WINX_WINAPI)
+
+#define WIN32_LEAN_AND_MEAN
+#ifndef _WIN32_WINNT
+#	define _WIN32_WINNT 0x0601 // needed for QueryDisplayConfig
+#endif
+#include <windows.h>
+#include <windowsx.h>
+#include <wchar.h>
+#include <gl/GL.h>
+
+// copied from wglext.h
+typedef BOOL(WINAPI * PFNWGLCHOOSEPIXELFORMATARBPROC) (HDC hdc, const int *piAttribIList, const FLOAT *pfAttribFList, UINT nMaxFormats, int *piFormats, UINT *nNumFormats);
+typedef HGLRC(WINAPI * PFNWGLCREATECONTEXTATTRIBSARBPROC) (HDC hDC, HGLRC hShareContext, const int *attribList);
+typedef BOOL(WINAPI * PFNWGLSWAPINTERVALEXTPROC) (int interval);
+
+#define WGL_SAMPLE_BUFFERS_ARB            0x2041
+#define WGL_SAMPLES_ARB                   0x2042
+#define WGL_DRAW_TO_WINDOW_ARB            0x2001
+#define WGL_SUPPORT_OPENGL_ARB            0x2010
+#define WGL_DOUBLE_BUFFER_ARB             0x2011
+#define WGL_PIXEL_TYPE_ARB                0x2013
+#define WGL_TYPE_RGBA_ARB                 0x202B
+#define WGL_ACCELERATION_ARB              0x2003
+#define WGL_FULL_ACCELERATION_ARB         0x2027
+#define WGL_COLOR_BITS_ARB                0x2014
+#define WGL_ALPHA_BITS_ARB                0x201B
+#define WGL_DEPTH_BITS_ARB                0x2022
+#define WGL_CONTEXT_MAJOR_VERSION_ARB     0x2091
+#define WGL_CONTEXT_MINOR_VERSION_ARB     0x2092
+#define WGL_CONTEXT_PROFILE_MASK_ARB      0x9126
+#define WGL_CONTEXT_CORE_PROFILE_BIT_ARB  0x00000001
+#define WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB 0x00000002
+#define WGL_SWAP_EXCHANGE_ARB             0x2028
+#define WGL_SWAP_METHOD_ARB               0x2007
+#define WGL_SWAP_COPY_ARB                 0x2029
+#define WGL_CONTEXT_FLAGS_ARB             0x2094
+#define WGL_CONTEXT_DEBUG_BIT_ARB         0x00000001
+#define WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB 0x00000004
+#define WGL_SAMPLE_BUFFERS_ARB            0x2041
+#define WGL_SAMPLES_ARB                   0x2042
+#define WGL_RED_BITS_ARB                  0x2015
+#define WGL_GREEN_BITS_ARB                0x2017
+#define WGL_BLUE_BITS_ARB                 0x2019
+#define WGL_STENCIL_BITS_ARB              0x2023
+#define WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB  0x20A9
+#define WGL_CONTEXT_OPENGL_NO_ERROR_ARB   0x31B3
+#define WGL_CONTEXT_RELEASE_BEHAVIOR_ARB  0x2097
+#define WGL_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB 0
+
+static PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT;
+
+// copied from vulkan_core.h and vulkan_win32.h
+typedef void (WINAPI * PFNVKVOIDFUNCTIONPROC) (void);
+typedef PFNVKVOIDFUNCTIONPROC (WINAPI * PFNVKGETINSTANCEPROCADDRPROC) (void* instance, const char* name);
+
+typedef struct {
+	int sType;
+	const void* pNext;
+	unsigned int flags;
+	HINSTANCE hinstance;
+	HWND hwnd;
+} VkWin32SurfaceCreateInfoKHR;
+
+typedef int (WINAPI * PFNVKCREATEWIN32SURFACEKHRPROC) (void* instance, const VkWin32SurfaceCreateInfoKHR* info, const void* allocator, void* surface);
+
+#define VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR 1000009000
+
+static PFNVKGETINSTANCEPROCADDRPROC vkGetInstanceProcAddr;
+
+// winx cursor image struct
+struct WinxCursor_s {
+	HCURSOR native;
+	WinxCursor* next;
+};
+
+// winx global state struct
+typedef struct {
+	HWND hndl;
+	HDC device;
+	HGLRC context;
+	bool no_error;
+	bool release_none;
+	bool srgb;
+
+	int mode;
+	HDC memory;
+	HBITMAP bitmap;
+	HGDIOBJ original;
+	unsigned int* pixels;
+	int x;
+	int y;
+	int width;
+	int height;
+
+	unsigned long long time;
+	bool focused;
+	bool mapped;
+	bool obscured;
+	bool hidden;
+	bool visible;
+	bool capture;
+	bool lazy;
+	long redraw;
+	bool fullscreen;
+	int throttle;
+	double throttle_time;
+	WINDOWPLACEMENT placement;
+	int monitor;
+	int monitor_count;
+	WinxMonitor* monitors;
+	HMONITOR* monitor_handles;
+	WinxCursor* cursor_icon;
+	WinxCursor* cursors;
+	WinxCursorEventHandle cursor;
+	WinxButtonEventHandle button;
+	WinxKeyboardEventHandle keyboard;
+	WinxScrollEventHandle scroll;
+	WinxCloseEventHandle close;
+	WinxResizeEventHandle resize;
+	WinxFocusEventHandle focus;
+	WinxExposeEventHandle expose;
+	WinxMonitorEventHandle monitor_change;
+	WinxVisibilityEventHandle visibility;
+	WinxNativeEventHandle native;
+	bool native_after;
+} WinxHandle;
+
+static WinxHandle* winx = NULL;
+
+static PROC winxGetProc(LPCSTR name) {
+	if (winxErrorMsg == NULL) {
+		PROC proc = wglGetProcAddress(name);
+
+		if (proc == NULL) {
+			winxErrorMsg = (char*) "wglGetProcAddress: Failed to load function!";
+		}
+
+		return proc;
+	}
+
+	return NULL;
+}
+
+static bool winxCreateFrameBuffer(int width, int height) {
+	BITMAPINFO info = {0};
+	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	info.bmiHeader.biWidth = width;
+	info.bmiHeader.biHeight = -height;
+	info.bmiHeader.biPlanes = 1;
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+
+	winx->bitmap = CreateDIBSection(winx->memory, &info, DIB_RGB_COLORS, (void**) &winx->pixels, NULL, 0);
+	if (!winx->bitmap) {
+		winxErrorMsg = (char*) "CreateDIBSection: Failed to create frame buffer!";
+		return false;
+	}
+
+	winx->original = SelectObject(winx->memory, winx->bitmap);
+	winx->width = width;
+	winx->height = height;
+
+	return true;
+}
+
+static void winxDeleteFrameBuffer() {
+	if (winx->bitmap) {
+		SelectObject(winx->memory, winx->original);
+		DeleteObject(winx->bitmap);
+
+		winx->bitmap = NULL;
+		winx->pixels = NULL;
+	}
+}
+
+static double winxGetRefreshRate(const MONITORINFOEXW* info) {
+	UINT32 path_count = 0, mode_count = 0;
+	double refresh = 0;
+
+	// the refresh rate reported by EnumDisplaySettings is rounded down to an integer (like 59 Hz),
+	// the display configuration API reports it as an exact rational number instead
+	if (GetDisplayConfigBufferSizes(QDC_ONLY_ACTIVE_PATHS, &path_count, &mode_count) == ERROR_SUCCESS) {
+		DISPLAYCONFIG_PATH_INFO* paths = (DISPLAYCONFIG_PATH_INFO*) calloc(path_count, sizeof(DISPLAYCONFIG_PATH_INFO));
+		DISPLAYCONFIG_MODE_INFO* modes = (DISPLAYCONFIG_MODE_INFO*) calloc(mode_count, sizeof(DISPLAYCONFIG_MODE_INFO));
+
+		if (QueryDisplayConfig(QDC_ONLY_ACTIVE_PATHS, &path_count, paths, &mode_count, modes, NULL) == ERROR_SUCCESS) {
+			for (UINT32 i = 0; i < path_count; i ++) {
+				DISPLAYCONFIG_SOURCE_DEVICE_NAME source = {0};
+				source.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+				source.header.size = sizeof(DISPLAYCONFIG_SOURCE_DEVICE_NAME);
+				source.header.adapterId = paths[i].sourceInfo.adapterId;
+				source.header.id = paths[i].sourceInfo.id;
+
+				const DISPLAYCONFIG_RATIONAL rate = paths[i].targetInfo.refreshRate;
+
+				if (DisplayConfigGetDeviceInfo(&source.header) == ERROR_SUCCESS && wcscmp(source.viewGdiDeviceName, info->szDevice) == 0 && rate.Denominator) {
+					refresh = rate.Numerator / (double) rate.Denominator;
+					break;
+				}
+			}
+		}
+
+		free(paths);
+		free(modes);
+	}
+
+	if (refresh == 0) {
+		DEVMODEW mode = {0};
+		mode.dmSize = sizeof(DEVMODEW);
+
+		if (EnumDisplaySettingsW(info->szDevice, ENUM_CURRENT_SETTINGS, &mode)) {
+			refresh = mode.dmDisplayFrequency;
+		}
+	}
+
+	return refresh;
+}
+
+static BOOL CALLBACK winxMonitorEnumProc(HMONITOR handle, HDC device, LPRECT rect, LPARAM param) {
+	MONITORINFOEXW info = {0};
+	info.cbSize = sizeof(MONITORINFOEXW);
+
+	if (GetMonitorInfoW(handle, (MONITORINFO*) &info)) {
+		winx->monitors = (WinxMonitor*) realloc(winx->monitors, (winx->monitor_count + 1) * sizeof(WinxMonitor));
+		winx->monitor_handles = (HMONITOR*) realloc(winx->monitor_handles, (winx->monitor_count + 1) * sizeof(HMONITOR));
+
+		WinxMonitor* monitor = winx->monitors + winx->monitor_count;
+		winx->monitor_handles[winx->monitor_count ++] = handle;
+
+		WideCharToMultiByte(CP_UTF8, 0, info.szDevice, -1, monitor->name, sizeof(monitor->name), NULL, NULL);
+		monitor->x = info.rcMonitor.left;
+		monitor->y = info.rcMonitor.top;
+		monitor->width = info.rcMonitor.right - info.rcMonitor.left;
+		monitor->height = info.rcMonitor.bottom - info.rcMonitor.top;
+		monitor->refresh = winxGetRefreshRate(&info);
+		monitor->primary = (info.dwFlags & MONITORINFOF_PRIMARY) != 0;
+	}
+
+	return TRUE;
+}
+
+static void winxUpdateMonitors() {
+	free(winx->monitors);
+	free(winx->monitor_handles);
+
+	winx->monitors = NULL;
+	winx->monitor_handles = NULL;
+	winx->monitor_count = 0;
+
+	EnumDisplayMonitors(NULL, NULL, winxMonitorEnumProc, 0);
+}
+
+static void winxUpdateWindowMonitor(bool changed) {
+	HMONITOR handle = MonitorFromWindow(winx->hndl, MONITOR_DEFAULTTONEAREST);
+	int index = 0;
+
+	for (int i = 0; i < winx->monitor_count; i ++) {
+		if (winx->monitor_handles[i] == handle) {
+			index = i;
+			break;
+		}
+	}
+
+	if (changed || index != winx->monitor) {
+		winx->monitor = index;
+		winx->monitor_change(index);
+	}
+}
+
+// windows always sends all input messages, there is no way to select them
+static void winxUpdateEventMask() {}
+
+static void winxSleep(double seconds) {
+	Sleep((DWORD) (seconds * 1000));
+}
+
+static void winxUpdateCursorState(bool captured, WinxCursor* cursor) {
+	if (captured) {
+		RECT rect;
+
+		// taken from GLFW
+		GetClientRect(winx->hndl, &rect);
+		ClientToScreen(winx->hndl, (POINT*) &rect.left);
+		ClientToScreen(winx->hndl, (POINT*) &rect.right);
+
+		bool success = ClipCursor(&rect);
+		if (!success) {
+			winxErrorMsg = (char*) "ClipCursor: Failed to clip cursor!";
+		}
+	} else {
+		ClipCursor(NULL);
+	}
+
+	if (cursor) {
+		SetCursor(cursor->native);
+	} else {
+		SetCursor(LoadCursor(NULL, IDC_ARROW));
+	}
+}
+
+static LRESULT CALLBACK winxWndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam) {
+	LRESULT result = 0;
+
+	switch (message) {
+		case WM_KEYDOWN:
+			WINX_SET_REDRAW(true);
+			winx->keyboard((lParam & (1 << 30)) ? WINX_REPEATED : WINX_PRESSED, wParam); // bit 30 is the previous key state
+			break;
+
+		case WM_KEYUP:
+			WINX_SET_REDRAW(true);
+			winx->keyboard(WINX_RELEASED, wParam);
+			break;
+
+		case WM_MOUSEMOVE:
+			WINX_SET_REDRAW(true);
+			winx->cursor(GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
+			break;
+
+		case WM_LBUTTONDOWN:
+			WINX_SET_REDRAW(true);
+			winx->button(WINX_PRESSED, WXB_LEFT);
+			break;
+
+		case WM_LBUTTONUP:
+			WINX_SET_REDRAW(true);
+			winx->button(WINX_RELEASED, WXB_LEFT);
+			break;
+
+		case WM_MBUTTONDOWN:
+			WINX_SET_REDRAW(true);
+			winx->button(WINX_PRESSED, WXB_CENTER);
+			break;
+
+		case WM_MBUTTONUP:
+			WINX_SET_REDRAW(true);
+			winx->button(WINX_RELEASED, WXB_CENTER);
+			break;
+
+		case WM_RBUTTONDOWN:
+			WINX_SET_REDRAW(true);
+			winx->button(WINX_PRESSED, WXB_RIGHT);
+			break;
+
+		case WM_RBUTTONUP:
+			WINX_SET_REDRAW(true);
+			winx->button(WINX_RELEASED, WXB_RIGHT);
+			break;
+
+		case WM_MOUSEWHEEL:
+			WINX_SET_REDRAW(true);
+			winx->scroll(GET_WHEEL_DELTA_WPARAM(wParam) / WHEEL_DELTA);
+			break;
+
+		case WM_CLOSE:
+			WINX_SET_REDRAW(true); // wake up the lazy event loop
+			winx->close();
+			break;
+
+		case WM_PAINT: {
+			PAINTSTRUCT paint;
+			BeginPaint(hWnd, &paint);
+
+			WINX_SET_REDRAW(true);
+			winx->expose(paint.rcPaint.left, paint.rcPaint.top, paint.rcPaint.right - paint.rcPaint.left, paint.rcPaint.bottom - paint.rcPaint.top);
+
+			EndPaint(hWnd, &paint);
+			break;
+		}
+
+		case WM_SIZE:
+			WINX_SET_REDRAW(true);
+			winx->width = LOWORD(lParam);
+			winx->height = HIWORD(lParam);
+			winx->mapped = wParam != SIZE_MINIMIZED; // minimized windows are unmapped on X11 too
+			winx->hidden = wParam == SIZE_MINIMIZED;
+			winxUpdateVisibility();
+
+			if (winx->mode == WINX_CONTEXT_SOFTWARE && winx->memory && LOWORD(lParam) && HIWORD(lParam)) {
+				winxDeleteFrameBuffer();
+				winxCreateFrameBuffer(LOWORD(lParam), HIWORD(lParam));
+			}
+
+			winx->resize(LOWORD(lParam), HIWORD(lParam));
+			break;
+
+		case WM_MOVE:
+			winx->x = GET_X_LPARAM(lParam);
+			winx->y = GET_Y_LPARAM(lParam);
+			winxUpdateWindowMonitor(false);
+			break;
+
+		case WM_SHOWWINDOW:
+			winx->mapped = wParam;
+			winxUpdateVisibility();
+			result = DefWindowProcA(hWnd, message, wParam, lParam);
+			break;
+
+		case WM_DISPLAYCHANGE:
+			winxUpdateMonitors();
+			winxUpdateWindowMonitor(true);
+			break;
+
+		case WM_SETFOCUS:
+			WINX_SET_REDRAW(true);
+			winx->focused = true;
+			winx->focus(true);
+			winxUpdateCursorState(winx->capture, winx->cursor_icon);
+			break;
+
+		case WM_KILLFOCUS:
+			WINX_SET_REDRAW(true);
+			winx->focused = false;
+			winx->focus(false);
+			winxUpdateCursorState(false, NULL);
+			break;
+
+		// needed because yes
+		// https://docs.microsoft.com/en-us/windows/win32/learnwin32/setting-the-cursor-image
+		case WM_SETCURSOR:
+			if (LOWORD(lParam) == HTCLIENT) {
+				winxUpdateCursorState(winx->capture, winx->cursor_icon);
+				return TRUE;
+			}
+			break;
+
+		default:
+			result = DefWindowProcA(hWnd, message, wParam, lParam);
+	}
+
+	return result;
+}
+
+// release everything created before winxOpen() failed, including the temporary window used to load WGL
+static bool winxAbortOpen(HWND fakeHndl, HDC fakeDeviceContext, HGLRC fakeRenderContext) {
+	if (fakeRenderContext) {
+		wglMakeCurrent(fakeDeviceContext, NULL);
+		wglDeleteContext(fakeRenderContext);
+	}
+
+	if (fakeDeviceContext) ReleaseDC(fakeHndl, fakeDeviceContext);
+	if (fakeHndl) DestroyWindow(fakeHndl);
+
+	winxClose();
+	return false;
+}
+
+bool winxOpen(int width, int height, const char* title) {
+	winx = (WinxHandle*) calloc(1, sizeof(WinxHandle));
+	winx->capture = false;
+	winx->lazy = __winx_hint_lazy;
+	winx->throttle = __winx_hint_throttle;
+	WINX_SET_REDRAW(true);
+	winx->mode = __winx_hint_context;
+
+	QueryPerformanceCounter((LARGE_INTEGER*) &winx->time);
+
+	HINSTANCE hinstance = GetModuleHandle(NULL);
+
+	// set dummy function pointers
+	winxResetEventHandles();
+
+	// register window class
+	const char* clazz = "WinxOpenGLClass";
+
+	WNDCLASSEXA wcex = {0};
+	wcex.cbSize = sizeof(WNDCLASSEX);
+	wcex.style = CS_OWNDC | CS_HREDRAW | CS_VREDRAW | CS_DBLCLKS;
+	wcex.lpfnWndProc = (WNDPROC) winxWndProc;
+	wcex.cbClsExtra = 0;
+	wcex.cbWndExtra = 0;
+	wcex.hInstance = hinstance;
+	wcex.hIcon = LoadIcon(NULL, IDI_WINLOGO);
+	wcex.hCursor = LoadCursor(NULL, IDC_ARROW);
+	wcex.hbrBackground = NULL;
+	wcex.lpszMenuName = NULL;
+	wcex.lpszClassName = clazz;
+	wcex.hIconSm = NULL;
+
+	// the class stays registered after winxClose(), so it only needs to be registered by the first winxOpen()
+	if (!RegisterClassExA(&wcex) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS) {
+		winxErrorMsg = (char*) "RegisterClassExA: Failed to register window class!";
+		return winxAbortOpen(NULL, NULL, NULL);
+	}
+
+	// software and Vulkan windows need no WGL context so skip the temporary window
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winx->hndl = CreateWindowA(clazz, title, WS_OVERLAPPEDWINDOW, 0, 0, width, height, NULL, NULL, hinstance, NULL);
+		if (!winx->hndl) {
+			winxErrorMsg = (char*) "CreateWindowA: Failed to create window!";
+			return winxAbortOpen(NULL, NULL, NULL);
+		}
+
+		winx->device = GetDC(winx->hndl);
+		if (!winx->device) {
+			winxErrorMsg = (char*) "GetDC: Failed to create device context!";
+			return winxAbortOpen(NULL, NULL, NULL);
+		}
+
+		if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+			winx->memory = CreateCompatibleDC(winx->device);
+			if (!winx->memory) {
+				winxErrorMsg = (char*) "CreateCompatibleDC: Failed to create device context!";
+				return winxAbortOpen(NULL, NULL, NULL);
+			}
+
+			RECT rect;
+			GetClientRect(winx->hndl, &rect);
+
+			if (!winxCreateFrameBuffer(rect.right - rect.left, rect.bottom - rect.top)) {
+				return winxAbortOpen(NULL, NULL, NULL);
+			}
+		}
+
+		winxUpdateMonitors();
+		winxUpdateWindowMonitor(false);
+
+		ShowWindow(winx->hndl, 1);
+		UpdateWindow(winx->hndl);
+
+		return true;
+	}
+
+	HWND fakeHndl = NULL;
+	HDC fakeDeviceContext = NULL;
+	HGLRC fakeRenderContext = NULL;
+
+	// create temporary window to get WGL context
+	fakeHndl = CreateWindowA(clazz, "WINX", WS_OVERLAPPEDWINDOW, 0, 0, 1, 1, NULL, NULL, hinstance, NULL);
+	if (!fakeHndl) {
+		winxErrorMsg = (char*) "CreateWindowA: Failed to create temporary window!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	fakeDeviceContext = GetDC(fakeHndl);
+	if (!fakeDeviceContext) {
+		winxErrorMsg = (char*) "GetDC: Failed to create temporary device context!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	PIXELFORMATDESCRIPTOR descriptor = {0};
 	descriptor.nSize = sizeof(PIXELFORMATDESCRIPTOR);
 	descriptor.nVersion = 1;
 	descriptor.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL;
@@ -711,374 +4076,2552 @@ bool winxOpen(int width, int height, const char* title) {
 	descriptor.cDepthBits = __winx_hint_depth_bits;
 	int fakePixelFormat = ChoosePixelFormat(fakeDeviceContext, &descriptor);
 
-	if (!fakePixelFormat) {
-		winxErrorMsg = (char*) "ChoosePixelFormat: Failed to choose a pixel format!";
-		return false;
+	if (!fakePixelFormat) {
+		winxErrorMsg = (char*) "ChoosePixelFormat: Failed to choose a pixel format!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	if (!SetPixelFormat(fakeDeviceContext, fakePixelFormat, &descriptor)) {
+		winxErrorMsg = (char*) "SetPixelFormat: Failed to select a pixel format!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	fakeRenderContext = wglCreateContext(fakeDeviceContext);
+	if (!fakeRenderContext) {
+		winxErrorMsg = (char*) "wglCreateContext: Failed to create temporary render context!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	// open real window
+	winx->hndl = CreateWindowA(clazz, title, WS_OVERLAPPEDWINDOW, 0, 0, width, height, NULL, NULL, hinstance, NULL);
+	if (!winx->hndl) {
+		winxErrorMsg = (char*) "CreateWindowA: Failed to create window!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	// create context
+	winx->device = GetDC(winx->hndl);
+	if (!winx->device) {
+		winxErrorMsg = (char*) "GetDC: Failed to create device context!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB;
+	PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
+
+	if (!wglMakeCurrent(fakeDeviceContext, fakeRenderContext)) {
+		winxErrorMsg = (char*) "wglMakeCurrent: Failed to select temporary context!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	wglChoosePixelFormatARB = (PFNWGLCHOOSEPIXELFORMATARBPROC) winxGetProc("wglChoosePixelFormatARB");
+	wglCreateContextAttribsARB = (PFNWGLCREATECONTEXTATTRIBSARBPROC) winxGetProc("wglCreateContextAttribsARB");
+	wglSwapIntervalEXT = (PFNWGLSWAPINTERVALEXTPROC) wglGetProcAddress("wglSwapIntervalEXT"); // optional
+
+	if (winxErrorMsg != NULL) {
+		// winxGetProc set the error message
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	int pixelFormat;
+	BOOL status;
+	UINT numFormats;
+
+	// the optional sRGB attribute is last, so that it can be cut off if there is no such pixel format
+	int pixelAttribs[] = {
+		WGL_DRAW_TO_WINDOW_ARB, GL_TRUE,
+		WGL_SUPPORT_OPENGL_ARB, GL_TRUE,
+		WGL_DOUBLE_BUFFER_ARB, GL_TRUE,
+		WGL_PIXEL_TYPE_ARB, WGL_TYPE_RGBA_ARB,
+		WGL_ACCELERATION_ARB, WGL_FULL_ACCELERATION_ARB,
+		WGL_RED_BITS_ARB, __winx_hint_red_bits,
+		WGL_GREEN_BITS_ARB, __winx_hint_green_bits,
+		WGL_BLUE_BITS_ARB, __winx_hint_blue_bits,
+		WGL_ALPHA_BITS_ARB, __winx_hint_alpha_bits,
+		WGL_DEPTH_BITS_ARB, __winx_hint_depth_bits,
+		WGL_STENCIL_BITS_ARB, __winx_hint_stencil_bits,
+		WGL_SAMPLE_BUFFERS_ARB, __winx_hint_multisamples ? 1 : 0,
+		WGL_SAMPLES_ARB, __winx_hint_multisamples,
+		WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB, GL_TRUE,
+		0
+	};
+
+	const int srgbAttrib = sizeof(pixelAttribs) / sizeof(int) - 3;
+	winx->srgb = __winx_hint_srgb;
+
+	if (!winx->srgb) {
+		pixelAttribs[srgbAttrib] = 0;
+	}
+
+	int flags = 0;
+
+	if (__winx_hint_opengl_debug) flags |= WGL_CONTEXT_DEBUG_BIT_ARB;
+	if (__winx_hint_opengl_robust) flags |= WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB;
+
+	int  contextAttributes[16] = {
+		WGL_CONTEXT_MAJOR_VERSION_ARB, __winx_hint_opengl_major,
+		WGL_CONTEXT_MINOR_VERSION_ARB, __winx_hint_opengl_minor,
+		WGL_CONTEXT_PROFILE_MASK_ARB, __winx_hint_opengl_core ? WGL_CONTEXT_CORE_PROFILE_BIT_ARB : WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
+		WGL_CONTEXT_FLAGS_ARB, flags,
+		0
+	};
+
+	// the optional attributes go at the end, so that they can be cut off if the context can't be created with them,
+	// wglCreateContextAttribsARB fails on unknown attributes so there is no need to check the extension list first
+	const int required = 8;
+	int count = required;
+
+	// a no-error context can't also be a debug or robust one
+	winx->no_error = __winx_hint_opengl_no_error && !flags;
+	winx->release_none = __winx_hint_opengl_release == WINX_RELEASE_NONE;
+
+	if (winx->no_error) {
+		contextAttributes[count ++] = WGL_CONTEXT_OPENGL_NO_ERROR_ARB;
+		contextAttributes[count ++] = GL_TRUE;
+	}
+
+	if (winx->release_none) {
+		contextAttributes[count ++] = WGL_CONTEXT_RELEASE_BEHAVIOR_ARB;
+		contextAttributes[count ++] = WGL_CONTEXT_RELEASE_BEHAVIOR_NONE_ARB;
+	}
+
+	contextAttributes[count] = 0;
+
+	status = wglChoosePixelFormatARB(winx->device, pixelAttribs, NULL, 1, &pixelFormat, &numFormats);
+
+	// drivers without WGL_ARB_framebuffer_sRGB fail on the unknown attribute
+	if (winx->srgb && (!status || !numFormats)) {
+		winx->srgb = false;
+		pixelAttribs[srgbAttrib] = 0;
+		status = wglChoosePixelFormatARB(winx->device, pixelAttribs, NULL, 1, &pixelFormat, &numFormats);
+	}
+
+	if (status && numFormats) {
+
+		PIXELFORMATDESCRIPTOR pfd;
+		memset(&pfd, 0, sizeof(PIXELFORMATDESCRIPTOR));
+		DescribePixelFormat(winx->device, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &pfd);
+
+		if (!SetPixelFormat(winx->device, pixelFormat, &pfd)) {
+			winxErrorMsg = (char*) "SetPixelFormat: Failed to select a pixel format!";
+			return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+		}
+
+		winx->context = wglCreateContextAttribsARB(winx->device, 0, contextAttributes);
+
+		if (!winx->context && count != required) {
+			winx->no_error = false;
+			winx->release_none = false;
+			contextAttributes[required] = 0;
+
+			winx->context = wglCreateContextAttribsARB(winx->device, 0, contextAttributes);
+		}
+
+		if (!winx->context) {
+			winxErrorMsg = (char*) "wglCreateContextAttribsARB: Failed to create a render context!";
+			return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+		}
+
+	} else {
+		winxErrorMsg = (char*) "wglChoosePixelFormatARB: Failed to choose a pixel format!";
+		return winxAbortOpen(fakeHndl, fakeDeviceContext, fakeRenderContext);
+	}
+
+	// close temporary window
+	wglMakeCurrent(fakeDeviceContext, NULL);
+	wglDeleteContext(fakeRenderContext);
+	ReleaseDC(fakeHndl, fakeDeviceContext);
+	DestroyWindow(fakeHndl);
+
+	fakeDeviceContext = NULL;
+	fakeRenderContext = NULL;
+	fakeHndl = NULL;
+
+	wglMakeCurrent(winx->device, winx->context);
+	winxInitGL();
+
+	// set vsync
+	winxSetVsync(__winx_hint_vsync);
+
+	// needed to track monitors
+	winxUpdateMonitors();
+	winxUpdateWindowMonitor(false);
+
+	RECT rect;
+	GetClientRect(winx->hndl, &rect);
+	winx->width = rect.right - rect.left;
+	winx->height = rect.bottom - rect.top;
+
+	// finish window creation
+	ShowWindow(winx->hndl, 1);
+	UpdateWindow(winx->hndl);
+
+	return true;
+}
+
+static void winxWaitForEvents() {
+	const double wait = winxGetTimerWait();
+
+	// wake up for the next timer, rounded up so that it is due by then
+	MsgWaitForMultipleObjects(0, NULL, FALSE, wait < 0 ? INFINITE : (DWORD) (wait * 1000) + 1, QS_ALLINPUT);
+}
+
+static void winxProcessEvents() {
+	MSG event;
+
+	// the window could have been closed from inside of one of the event handles
+	while (winx && PeekMessageA(&event, NULL, 0, 0, PM_REMOVE)) {
+		if (!winx->native_after && winx->native(&event)) {
+			continue;
+		}
+
+		TranslateMessage(&event);
+		DispatchMessage(&event);
+
+		if (winx && winx->native_after) {
+			winx->native(&event);
+		}
+	}
+
+	if (winx) {
+		winxDispatchSources();
+	}
+}
+
+void winxPollEvents() {
+	winxProcessEvents();
+
+	// in lazy mode block until there is something to redraw
+	while (winx && winx->lazy && !WINX_GET_REDRAW()) {
+		winxWaitForEvents();
+		winxProcessEvents();
+	}
+}
+
+void winxWaitEvents() {
+	winxWaitForEvents();
+	winxProcessEvents();
+}
+
+void winxMakeContextCurrent() {
+	WINX_CONTEXT_ASSERT("winxMakeContextCurrent");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxMakeContextCurrent: Current window has no OpenGL context!";
+		return;
+	}
+
+	if (!wglMakeCurrent(winx->device, winx->context)) {
+		winxErrorMsg = (char*) "wglMakeCurrent: Failed to make context current!";
+	}
+}
+
+void winxReleaseContext() {
+	WINX_CONTEXT_ASSERT("winxReleaseContext");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		return;
+	}
+
+	wglMakeCurrent(NULL, NULL);
+}
+
+void winxSwapBuffers() {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxPresentPixels(NULL, 0);
+		return;
+	}
+
+	// the frame was presented by Vulkan
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	winxEndFrame();
+	SwapBuffers(winx->device);
+}
+
+void winxSwapBuffersWithDamage(const int* rects, int count) {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxPresentPixels(rects, count);
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	// WGL has no way of presenting only a part of the back buffer
+	winxEndFrame();
+	SwapBuffers(winx->device);
+}
+
+bool winxGetDamageSupport() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetDamageSupport: No active winx context!";
+		return false;
+	}
+
+	return winx->mode == WINX_CONTEXT_SOFTWARE;
+}
+
+const WinxInputSample* winxGetInputSamples(int* count) {
+	// touch and pen input would need WM_POINTER messages, which are not handled yet
+	*count = 0;
+	return NULL;
+}
+
+bool winxGetPresentTiming(double* time, double* interval) {
+	// DWM frame statistics are not exposed yet
+	*time = 0;
+	*interval = 0;
+	return false;
+}
+
+unsigned int* winxGetPixels() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetPixels: No active winx context!";
+		return NULL;
+	}
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxGetPixels: Current window is not a software window!";
+		return NULL;
+	}
+
+	// the frame buffer is NULL if it couldn't be recreated after a resize
+	if (!winx->pixels) {
+		winxErrorMsg = (char*) "winxGetPixels: Failed to create frame buffer!";
+	}
+
+	return winx->pixels;
+}
+
+void winxPresentPixels(const int* rects, int count) {
+	WINX_CONTEXT_ASSERT("winxPresentPixels");
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxPresentPixels: Current window is not a software window!";
+		return;
+	}
+
+	WINX_SET_REDRAW(false);
+
+	int full[4] = {0, 0, winx->width, winx->height};
+	int rect[4];
+
+	if (!rects || count <= 0) {
+		rects = full;
+		count = 1;
+	}
+
+	// GDI copies the pixels right away, so there is no need for a second buffer
+	for (int i = 0; i < count * 4; i += 4) {
+		if (winxClipRect(rects + i, winx->width, winx->height, rect)) {
+			BitBlt(winx->device, rect[0], rect[1], rect[2], rect[3], winx->memory, rect[0], rect[1], SRCCOPY);
+		}
+	}
+
+	GdiFlush();
+}
+
+void winxClose() {
+	winxFreeSources();
+	winxFreeCursors();
+
+	// also used when winxOpen() failed, so any of the handles below could be missing
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winxDeleteFrameBuffer();
+		if (winx->memory) DeleteDC(winx->memory);
+	} else if (winx->mode == WINX_CONTEXT_OPENGL && winx->context) {
+		// the render thread has released the context, take it back to free the objects created in it
+		wglMakeCurrent(winx->device, winx->context);
+		winxFreeGL();
+		wglMakeCurrent(winx->device, NULL);
+		wglDeleteContext(winx->context);
+	}
+
+	if (winx->device) ReleaseDC(winx->hndl, winx->device);
+	if (winx->hndl) DestroyWindow(winx->hndl);
+
+	free(winx->monitors);
+	free(winx->monitor_handles);
+	free(winx);
+	winx = NULL;
+}
+
+void winxTerminate() {
+	// windows has no display connection to keep alive, the WINX_HINT_PERSISTENT hint is ignored
+}
+
+void* winxGetProcAddress(const char* name) {
+	void* proc = (void*) wglGetProcAddress(name);
+
+	// wglGetProcAddress only returns functions not exported by opengl32.dll and
+	// can return small integers instead of NULL on failure, see https://www.khronos.org/opengl/wiki/Load_OpenGL_Functions
+	if (proc == NULL || proc == (void*) 0x1 || proc == (void*) 0x2 || proc == (void*) 0x3 || proc == (void*) -1) {
+		proc = (void*) GetProcAddress(GetModuleHandleA("opengl32.dll"), name);
+	}
+
+	return proc;
+}
+
+// the Vulkan loader is only opened when it's needed, so that winx doesn't depend on it
+static bool winxLoadVulkan() {
+	if (!vkGetInstanceProcAddr) {
+		HMODULE library = LoadLibraryA("vulkan-1.dll");
+
+		if (!library) {
+			winxErrorMsg = (char*) "LoadLibraryA: Failed to load the Vulkan loader!";
+			return false;
+		}
+
+		vkGetInstanceProcAddr = (PFNVKGETINSTANCEPROCADDRPROC) (void*) GetProcAddress(library, "vkGetInstanceProcAddr");
+	}
+
+	return vkGetInstanceProcAddr != NULL;
+}
+
+const char** winxGetRequiredVulkanInstanceExtensions(int* count) {
+	static const char* extensions[] = {"VK_KHR_surface", "VK_KHR_win32_surface"};
+
+	if (!winxLoadVulkan()) {
+		*count = 0;
+		return NULL;
+	}
+
+	*count = 2;
+	return extensions;
+}
+
+bool winxCreateVulkanSurface(void* instance, const void* allocator, void* surface) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: No active winx context!";
+		return false;
+	}
+
+	if (!winxLoadVulkan()) {
+		return false;
+	}
+
+	PFNVKCREATEWIN32SURFACEKHRPROC vkCreateWin32SurfaceKHR = (PFNVKCREATEWIN32SURFACEKHRPROC) vkGetInstanceProcAddr(instance, "vkCreateWin32SurfaceKHR");
+
+	if (!vkCreateWin32SurfaceKHR) {
+		winxErrorMsg = (char*) "winxCreateVulkanSurface: Instance was created without VK_KHR_win32_surface!";
+		return false;
+	}
+
+	VkWin32SurfaceCreateInfoKHR info = {VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR, NULL, 0, GetModuleHandle(NULL), winx->hndl};
+
+	if (vkCreateWin32SurfaceKHR(instance, &info, allocator, surface) != 0) {
+		winxErrorMsg = (char*) "vkCreateWin32SurfaceKHR: Failed to create surface!";
+		return false;
+	}
+
+	return true;
+}
+
+void winxSetTitle(const char* title) {
+	WINX_CONTEXT_ASSERT("winxSetTitle");
+
+	SetWindowTextA(winx->hndl, title);
+}
+
+static HICON winxCreateIcon(int width, int height, unsigned char* buffer, bool is_icon, int x_hot, int y_hot) {
+	char* target = NULL;
+	BITMAPV5HEADER header = {0};
+
+	header.bV5Size        = sizeof(header);
+	header.bV5Width       = width;
+	header.bV5Height      = -height;
+	header.bV5Planes      = 1;
+	header.bV5BitCount    = 32;
+	header.bV5Compression = BI_BITFIELDS;
+
+	// the order needs to be presisly like that
+	// otherwise alpha doesn't work
+	header.bV5RedMask     = 0x00ff0000;
+	header.bV5GreenMask   = 0x0000ff00;
+	header.bV5BlueMask    = 0x000000ff;
+	header.bV5AlphaMask   = 0xff000000;
+
+	HDC dc = GetDC(NULL);
+
+	if (!dc) {
+		winxErrorMsg = (char*) "GetDC: Failed to acquire drawable!";
+		return NULL;
+	}
+
+	HBITMAP mask = CreateBitmap(width, height, 1, 1, NULL);
+	HBITMAP color = CreateDIBSection(dc, (BITMAPINFO*) &header, DIB_RGB_COLORS, (void**) &target, NULL, 0);
+	ReleaseDC(NULL, dc);
+
+	for (int i = 0; i < width * height;  i++) {
+		target[0] = buffer[0];
+		target[1] = buffer[1];
+		target[2] = buffer[2];
+		target[3] = buffer[3];
+
+		target += 4;
+		buffer += 4;
+	}
+
+	ICONINFO info = {0};
+	info.fIcon = is_icon;
+	info.xHotspot = x_hot;
+	info.yHotspot = y_hot;
+	info.hbmMask = mask;
+	info.hbmColor = color;
+
+	HICON icon = CreateIconIndirect(&info);
+
+	DeleteObject(color);
+	DeleteObject(mask);
+
+	if (!icon) {
+		winxErrorMsg = (char*) "CreateIconIndirect: Failed to create icon handle!";
+		return NULL;
+	}
+
+	return icon;
+}
+
+void winxSetIcon(int width, int height, unsigned char* buffer) {
+	WINX_CONTEXT_ASSERT("winxSetIcon");
+
+	HICON largeIcon, smallIcon;
+
+	if (!buffer) {
+
+		largeIcon = (HICON) GetClassLongPtrW(winx->hndl, GCLP_HICON);
+        smallIcon = (HICON) GetClassLongPtrW(winx->hndl, GCLP_HICONSM);
+
+	} else {
+
+		HICON icon = winxCreateIcon(width, height, buffer, true, 0, 0);
+
+		if (icon == NULL) {
+			// don't set the error message as it must
+			// have been already set by winxCreateIcon
+			return;
+		}
+
+		largeIcon = icon;
+		smallIcon = icon;
+
+	}
+
+	SendMessage(winx->hndl, WM_SETICON, ICON_BIG, (LPARAM) largeIcon);
+	SendMessage(winx->hndl, WM_SETICON, ICON_SMALL, (LPARAM) smallIcon);
+}
+
+void winxSetFullscreen(bool fullscreen) {
+	WINX_CONTEXT_ASSERT("winxSetFullscreen");
+
+	if (winx->fullscreen == fullscreen) {
+		return;
+	}
+
+	// a borderless window that covers the whole monitor is
+	// presented by DWM directly, without being composited
+	if (fullscreen) {
+		MONITORINFO monitor = {0};
+		monitor.cbSize = sizeof(MONITORINFO);
+
+		winx->placement.length = sizeof(WINDOWPLACEMENT);
+		GetWindowPlacement(winx->hndl, &winx->placement);
+		GetMonitorInfoA(MonitorFromWindow(winx->hndl, MONITOR_DEFAULTTONEAREST), &monitor);
+
+		const RECT rect = monitor.rcMonitor;
+		SetWindowLongPtrA(winx->hndl, GWL_STYLE, WS_POPUP | WS_VISIBLE);
+		SetWindowPos(winx->hndl, HWND_TOP, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
+	} else {
+		SetWindowLongPtrA(winx->hndl, GWL_STYLE, WS_OVERLAPPEDWINDOW | WS_VISIBLE);
+		SetWindowPlacement(winx->hndl, &winx->placement);
+		SetWindowPos(winx->hndl, NULL, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOZORDER | SWP_NOOWNERZORDER | SWP_FRAMECHANGED);
+	}
+
+	winx->fullscreen = fullscreen;
+}
+
+WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, int x, int y) {
+	if (buffer == NULL) {
+		return NULL;
+	}
+
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateCursorIcon: No active winx context!";
+		return NULL;
+	}
+
+	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
+	cursor->native = winxCreateIcon(width, height, buffer, false, x, y);
+	winxTrackCursor(cursor);
+
+	return cursor;
+}
+
+WinxCursor* winxCreateNullCursorIcon() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateNullCursorIcon: No active winx context!";
+		return NULL;
+	}
+
+	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
+	cursor->native = NULL;
+	winxTrackCursor(cursor);
+
+	return cursor;
+}
+
+void winxDeleteCursorIcon(WinxCursor* cursor) {
+	WINX_CONTEXT_ASSERT("winxDeleteCursorIcon");
+
+	if (cursor && winxUntrackCursor(cursor)) {
+		if (cursor->native) {
+			DestroyIcon((HICON) cursor->native);
+		}
+
+		free(cursor);
+	}
+}
+
+void winxSetVsync(int vsync) {
+	WINX_CONTEXT_ASSERT("winxSetVsync");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		return;
+	}
+
+	if (wglSwapIntervalEXT) {
+		wglSwapIntervalEXT(__winx_hint_vsync);
+	}
+}
+
+void winxSetFocus() {
+	WINX_CONTEXT_ASSERT("winxSetFocus");
+
+	SetActiveWindow(winx->hndl);
+	SetForegroundWindow(winx->hndl);
+	SetFocus(winx->hndl);
+}
+
+void winxSetCursorPos(int x, int y) {
+	WINX_CONTEXT_ASSERT("winxSetCursorPos");
+
+	POINT pos = {x, y};
+
+	ClientToScreen(winx->hndl, &pos);
+	SetCursorPos(pos.x, pos.y);
+}
+
+void* winxGetNativeDisplay() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeDisplay: No active winx context!";
+		return NULL;
+	}
+
+	return winx->device;
+}
+
+void* winxGetNativeWindow() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeWindow: No active winx context!";
+		return NULL;
+	}
+
+	return winx->hndl;
+}
+
+double winxGetTime() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetTime: No active winx context!";
+		return 0;
+	}
+
+	unsigned long long frequency, count;
+	QueryPerformanceFrequency((LARGE_INTEGER*) &frequency);
+	QueryPerformanceCounter((LARGE_INTEGER*) &count);
+
+	return (count - winx->time) / (double) frequency;
+}
+
+#endif // WINAPI
+
+// begin winx null implementation
+#if defined(WINX_NULL)
+
+#include <string.h>
+
+// copied from gl.h, only the types are needed as no OpenGL functions can be resolved
+#ifndef APIENTRY
+#	define APIENTRY
+#endif
+
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLubyte;
+typedef unsigned int GLuint;
+
+#define GL_FALSE 0
+#define GL_TRUE 1
+#define GL_BACK 0x0405
+#define GL_READ_BUFFER 0x0C02
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_RGBA 0x1908
+#define GL_EXTENSIONS 0x1F03
+#define GL_DONT_CARE 0x1100
+
+// winx cursor image struct
+struct WinxCursor_s {
+	int width;
+	int height;
+	WinxCursor* next;
+};
+
+// winx global state struct
+typedef struct {
+	int mode;
+	unsigned int* pixels;
+	bool no_error;
+	bool release_none;
+	bool srgb;
+
+	WinxNullEvent* events;
+	int event_head;
+	int event_count;
+	int event_capacity;
+
+	double clock;
+	double swap_interval;
+	double swap_time;
+	int swap_count;
+
+	int monitor;
+	int monitor_count;
+	WinxMonitor* monitors;
+
+	int x;
+	int y;
+	int width;
+	int height;
+	bool focused;
+	bool mapped;
+	bool obscured;
+	bool hidden;
+	bool visible;
+	bool capture;
+	bool lazy;
+	long redraw;
+	int throttle;
+	double throttle_time;
+	WinxCursor* cursor_icon;
+	WinxCursor* cursors;
+	WinxCursorEventHandle cursor;
+	WinxButtonEventHandle button;
+	WinxKeyboardEventHandle keyboard;
+	WinxScrollEventHandle scroll;
+	WinxCloseEventHandle close;
+	WinxResizeEventHandle resize;
+	WinxFocusEventHandle focus;
+	WinxExposeEventHandle expose;
+	WinxMonitorEventHandle monitor_change;
+	WinxVisibilityEventHandle visibility;
+	WinxNativeEventHandle native;
+	bool native_after;
+} WinxHandle;
+
+static WinxHandle* winx = NULL;
+
+static void winxUpdateEventMask() {}
+
+static void winxSleep(double seconds) {
+	// there is nothing to wait for, so only let the fake time pass
+	winx->clock += seconds;
+}
+
+static void winxUpdateCursorState(bool captured, WinxCursor* cursor) {}
+
+bool winxOpen(int width, int height, const char* title) {
+	winx = (WinxHandle*) calloc(1, sizeof(WinxHandle));
+	winx->mode = __winx_hint_context;
+	winx->width = width;
+	winx->height = height;
+	winx->lazy = __winx_hint_lazy;
+	winx->throttle = __winx_hint_throttle;
+	WINX_SET_REDRAW(true);
+	winx->swap_interval = 1.0 / 60;
+
+	// set dummy function pointers
+	winxResetEventHandles();
+
+	if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+		winx->pixels = (unsigned int*) calloc((size_t) width * height, sizeof(unsigned int));
+	}
+
+	// a single fake monitor, big enough for most test windows
+	winx->monitor_count = 1;
+	winx->monitors = (WinxMonitor*) calloc(1, sizeof(WinxMonitor));
+	strcpy(winx->monitors[0].name, "NULL");
+	winx->monitors[0].width = 1920;
+	winx->monitors[0].height = 1080;
+	winx->monitors[0].refresh = 60;
+	winx->monitors[0].primary = true;
+
+	if (winx->mode == WINX_CONTEXT_OPENGL) {
+		winxInitGL();
+	}
+
+	// the window is shown and focused right away, there is no window manager to wait for
+	winx->mapped = true;
+	winx->focused = true;
+	winxUpdateVisibility();
+
+	return true;
+}
+
+static void winxProcessEvent(const WinxNullEvent* event) {
+	WINX_SET_REDRAW(true);
+
+	switch (event->type) {
+
+		case WINX_NULL_CURSOR:
+			winx->cursor(event->x, event->y);
+			break;
+
+		case WINX_NULL_BUTTON:
+			winx->button(event->state, event->code);
+			break;
+
+		case WINX_NULL_KEYBOARD:
+			winx->keyboard(event->state, event->code);
+			break;
+
+		case WINX_NULL_SCROLL:
+			winx->scroll(event->code);
+			break;
+
+		case WINX_NULL_CLOSE:
+			winx->close();
+			break;
+
+		case WINX_NULL_RESIZE:
+			winx->width = event->width;
+			winx->height = event->height;
+
+			if (winx->mode == WINX_CONTEXT_SOFTWARE) {
+				free(winx->pixels);
+				winx->pixels = (unsigned int*) calloc((size_t) event->width * event->height, sizeof(unsigned int));
+			}
+
+			winx->resize(event->width, event->height);
+			break;
+
+		case WINX_NULL_FOCUS:
+			winx->focused = event->state;
+			winx->focus(event->state);
+			break;
+
+		case WINX_NULL_EXPOSE:
+			winx->expose(event->x, event->y, event->width, event->height);
+			break;
+
+		case WINX_NULL_MONITOR:
+			winx->monitor = event->code;
+			winx->monitor_change(event->code);
+			break;
+
+		case WINX_NULL_VISIBILITY:
+			winx->hidden = !event->state;
+			winxUpdateVisibility();
+			break;
+
+	}
+}
+
+static void winxProcessEvents() {
+	// the window could have been closed from inside of one of the event handlers
+	while (winx && winx->event_head < winx->event_count) {
+		// copied as the handles can push more events and so move the queue
+		WinxNullEvent event = winx->events[winx->event_head ++];
+
+		if (!winx->native_after && winx->native(&event)) {
+			continue;
+		}
+
+		winxProcessEvent(&event);
+
+		if (winx && winx->native_after) {
+			winx->native(&event);
+		}
+	}
+
+	if (winx) {
+		winx->event_head = 0;
+		winx->event_count = 0;
+	}
+
+	winxDispatchSources();
+}
+
+void winxPollEvents() {
+	double wait;
+	winxProcessEvents();
+
+	// in lazy mode skip the fake time ahead to each next timer until there is something to redraw,
+	// without timers there is nothing to block on, only the caller can queue more events
+	while (winx && winx->lazy && !WINX_GET_REDRAW() && (wait = winxGetTimerWait()) >= 0) {
+		winx->clock += wait;
+		winxProcessEvents();
+	}
+}
+
+void winxWaitEvents() {
+	const double wait = winxGetTimerWait();
+
+	// nothing is queued, so the next timer is the first thing that could happen
+	if (winx->event_count == 0 && wait > 0) {
+		winx->clock += wait;
+	}
+
+	winxProcessEvents();
+}
+
+void winxNullPushEvent(const WinxNullEvent* event) {
+	WINX_CONTEXT_ASSERT("winxNullPushEvent");
+
+	if (winx->event_count == winx->event_capacity) {
+		winx->event_capacity = winx->event_capacity ? winx->event_capacity * 2 : 64;
+		winx->events = (WinxNullEvent*) realloc(winx->events, winx->event_capacity * sizeof(WinxNullEvent));
+	}
+
+	winx->events[winx->event_count ++] = *event;
+}
+
+void winxNullSetSwapInterval(double seconds) {
+	WINX_CONTEXT_ASSERT("winxNullSetSwapInterval");
+	winx->swap_interval = seconds;
+}
+
+void winxNullAdvanceTime(double seconds) {
+	WINX_CONTEXT_ASSERT("winxNullAdvanceTime");
+	winx->clock += seconds;
+}
+
+int winxNullGetSwapCount() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxNullGetSwapCount: No active winx context!";
+		return 0;
+	}
+
+	return winx->swap_count;
+}
+
+void winxMakeContextCurrent() {
+	WINX_CONTEXT_ASSERT("winxMakeContextCurrent");
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxMakeContextCurrent: Current window has no OpenGL context!";
+	}
+}
+
+void winxReleaseContext() {
+	WINX_CONTEXT_ASSERT("winxReleaseContext");
+}
+
+// each presented frame takes exactly one swap interval of the fake time
+static void winxPresentFrame() {
+	winx->clock += winx->swap_interval;
+	winx->swap_time = winx->clock;
+	winx->swap_count ++;
+}
+
+void winxSwapBuffers() {
+	WINX_SET_REDRAW(false);
+
+	if (winxThrottleFrame()) {
+		return;
+	}
+
+	// the frame would have been presented by Vulkan
+	if (winx->mode == WINX_CONTEXT_NONE) {
+		return;
+	}
+
+	if (winx->mode == WINX_CONTEXT_OPENGL) {
+		winxEndFrame();
+	}
+
+	winxPresentFrame();
+}
+
+void winxSwapBuffersWithDamage(const int* rects, int count) {
+	winxSwapBuffers();
+}
+
+bool winxGetDamageSupport() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetDamageSupport: No active winx context!";
+		return false;
+	}
+
+	return true;
+}
+
+const WinxInputSample* winxGetInputSamples(int* count) {
+	*count = 0;
+	return NULL;
+}
+
+bool winxGetPresentTiming(double* time, double* interval) {
+	if (!winx || !winx->swap_count) {
+		*time = 0;
+		*interval = 0;
+		return false;
+	}
+
+	*time = winx->swap_time;
+	*interval = winx->swap_interval;
+	return true;
+}
+
+unsigned int* winxGetPixels() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetPixels: No active winx context!";
+		return NULL;
+	}
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxGetPixels: Current window is not a software window!";
+		return NULL;
+	}
+
+	return winx->pixels;
+}
+
+void winxPresentPixels(const int* rects, int count) {
+	WINX_CONTEXT_ASSERT("winxPresentPixels");
+
+	if (winx->mode != WINX_CONTEXT_SOFTWARE) {
+		winxErrorMsg = (char*) "winxPresentPixels: Current window is not a software window!";
+		return;
+	}
+
+	WINX_SET_REDRAW(false);
+	winxPresentFrame();
+}
+
+void winxClose() {
+	winxFreeSources();
+	winxFreeCursors();
+
+	if (winx->mode == WINX_CONTEXT_OPENGL) {
+		winxFreeGL();
+	}
+
+	free(winx->pixels);
+	free(winx->events);
+	free(winx->monitors);
+	free(winx);
+	winx = NULL;
+}
+
+void winxTerminate() {
+	// nothing is kept alive, the WINX_HINT_PERSISTENT hint is ignored
+}
+
+void* winxGetProcAddress(const char* name) {
+	return NULL;
+}
+
+const char** winxGetRequiredVulkanInstanceExtensions(int* count) {
+	winxErrorMsg = (char*) "winxGetRequiredVulkanInstanceExtensions: Vulkan is not available!";
+	*count = 0;
+	return NULL;
+}
+
+bool winxCreateVulkanSurface(void* instance, const void* allocator, void* surface) {
+	winxErrorMsg = (char*) "winxCreateVulkanSurface: Vulkan is not available!";
+	return false;
+}
+
+void winxSetTitle(const char* title) {
+	WINX_CONTEXT_ASSERT("winxSetTitle");
+}
+
+void winxSetIcon(int width, int height, unsigned char* buffer) {
+	WINX_CONTEXT_ASSERT("winxSetIcon");
+}
+
+void winxSetFullscreen(bool fullscreen) {
+	WINX_CONTEXT_ASSERT("winxSetFullscreen");
+}
+
+WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, int x, int y) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxCreateCursorIcon: No active winx context!";
+		return NULL;
+	}
+
+	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
+	cursor->width = width;
+	cursor->height = height;
+	winxTrackCursor(cursor);
+
+	return cursor;
+}
+
+WinxCursor* winxCreateNullCursorIcon() {
+	return winxCreateCursorIcon(1, 1, NULL, 0, 0);
+}
+
+void winxDeleteCursorIcon(WinxCursor* cursor) {
+	WINX_CONTEXT_ASSERT("winxDeleteCursorIcon");
+
+	if (cursor && winxUntrackCursor(cursor)) {
+		free(cursor);
+	}
+}
+
+void winxSetVsync(int vsync) {
+	WINX_CONTEXT_ASSERT("winxSetVsync");
+}
+
+void winxSetFocus() {
+	WINX_CONTEXT_ASSERT("winxSetFocus");
+}
+
+void winxSetCursorPos(int x, int y) {
+	WINX_CONTEXT_ASSERT("winxSetCursorPos");
+}
+
+void* winxGetNativeDisplay() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeDisplay: No active winx context!";
+	}
+
+	return NULL;
+}
+
+void* winxGetNativeWindow() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetNativeWindow: No active winx context!";
+	}
+
+	return NULL;
+}
+
+double winxGetTime() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetTime: No active winx context!";
+		return 0;
+	}
+
+	return winx->clock;
+}
+
+#endif // NULL
+
+// begin winx common OpenGL code
+// not all platforms ship glext.h, so the needed parts are copied here
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef GL_VERSION_1_5
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+#endif
+
+#ifndef GL_VERSION_3_2
+typedef struct __GLsync* GLsync;
+typedef uint64_t GLuint64;
+#endif
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#	define GL_PIXEL_PACK_BUFFER 0x88EB
+#	define GL_PIXEL_PACK_BUFFER_BINDING 0x88ED
+#endif
+
+#ifndef GL_STREAM_READ
+#	define GL_STREAM_READ 0x88E1
+#endif
+
+#ifndef GL_MAP_READ_BIT
+#	define GL_MAP_READ_BIT 0x0001
+#endif
+
+#ifndef GL_READ_FRAMEBUFFER
+#	define GL_READ_FRAMEBUFFER 0x8CA8
+#	define GL_READ_FRAMEBUFFER_BINDING 0x8CAA
+#endif
+
+#ifndef GL_VERSION_2_0
+typedef char GLchar;
+#endif
+
+#ifndef GL_NUM_EXTENSIONS
+#	define GL_MAJOR_VERSION 0x821B
+#	define GL_MINOR_VERSION 0x821C
+#	define GL_NUM_EXTENSIONS 0x821D
+#endif
+
+#ifndef GL_CONTEXT_FLAGS
+#	define GL_CONTEXT_FLAGS 0x821E
+#	define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#endif
+
+#ifndef GL_CONTEXT_FLAG_ROBUST_ACCESS_BIT
+#	define GL_CONTEXT_FLAG_ROBUST_ACCESS_BIT 0x00000004
+#endif
+
+#ifndef GL_CONTEXT_PROFILE_MASK
+#	define GL_CONTEXT_PROFILE_MASK 0x9126
+#	define GL_CONTEXT_CORE_PROFILE_BIT 0x00000001
+#endif
+
+#ifndef GL_DEBUG_OUTPUT
+#	define GL_DEBUG_OUTPUT 0x92E0
+#	define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#	define GL_DEBUG_TYPE_ERROR 0x824C
+#	define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#	define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#	define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#	define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#	define GL_DEBUG_SEVERITY_HIGH 0x9146
+#	define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#	define GL_DEBUG_SEVERITY_LOW 0x9148
+#	define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+#ifndef GL_QUERY_RESULT
+#	define GL_QUERY_RESULT 0x8866
+#	define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+#ifndef GL_TIMESTAMP
+#	define GL_TIMESTAMP 0x8E28
+#endif
+
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#	define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#	define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#	define GL_ALREADY_SIGNALED 0x911A
+#	define GL_CONDITION_SATISFIED 0x911C
+#	define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+
+// OpenGL functions used internally by winx
+static struct {
+	void (APIENTRY *GetIntegerv) (GLenum pname, GLint* data);
+	void (APIENTRY *ReadBuffer) (GLenum src);
+	void (APIENTRY *ReadPixels) (GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+	void (APIENTRY *GenBuffers) (GLsizei n, GLuint* buffers);
+	void (APIENTRY *DeleteBuffers) (GLsizei n, const GLuint* buffers);
+	void (APIENTRY *BindBuffer) (GLenum target, GLuint buffer);
+	void (APIENTRY *BufferData) (GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+	void* (APIENTRY *MapBufferRange) (GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+	GLboolean (APIENTRY *UnmapBuffer) (GLenum target);
+	void (APIENTRY *BindFramebuffer) (GLenum target, GLuint framebuffer);
+	GLsync (APIENTRY *FenceSync) (GLenum condition, GLbitfield flags);
+	GLenum (APIENTRY *ClientWaitSync) (GLsync sync, GLbitfield flags, GLuint64 timeout);
+	void (APIENTRY *DeleteSync) (GLsync sync);
+	void (APIENTRY *Enable) (GLenum cap);
+	const GLubyte* (APIENTRY *GetString) (GLenum name);
+	const GLubyte* (APIENTRY *GetStringi) (GLenum name, GLuint index);
+	void (APIENTRY *DebugMessageCallback) (void (APIENTRY *callback) (GLenum, GLenum, GLuint, GLenum, GLsizei, const GLchar*, const void*), const void* user);
+	void (APIENTRY *DebugMessageControl) (GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint* ids, GLboolean enabled);
+	void (APIENTRY *GenQueries) (GLsizei n, GLuint* ids);
+	void (APIENTRY *DeleteQueries) (GLsizei n, const GLuint* ids);
+	void (APIENTRY *QueryCounter) (GLuint id, GLenum target);
+	void (APIENTRY *GetQueryObjectiv) (GLuint id, GLenum pname, GLint* params);
+	void (APIENTRY *GetQueryObjectui64v) (GLuint id, GLenum pname, GLuint64* params);
+} winxGL;
+
+static bool winxLoadGL() {
+	#define WINX_LOAD_GL(name) *((void**) &winxGL.name) = winxGetProcAddress("gl" #name)
+	WINX_LOAD_GL(GetIntegerv);
+	WINX_LOAD_GL(ReadBuffer);
+	WINX_LOAD_GL(ReadPixels);
+	WINX_LOAD_GL(GenBuffers);
+	WINX_LOAD_GL(DeleteBuffers);
+	WINX_LOAD_GL(BindBuffer);
+	WINX_LOAD_GL(BufferData);
+	WINX_LOAD_GL(MapBufferRange);
+	WINX_LOAD_GL(UnmapBuffer);
+	WINX_LOAD_GL(BindFramebuffer);
+	WINX_LOAD_GL(FenceSync); // optional
+	WINX_LOAD_GL(ClientWaitSync); // optional
+	WINX_LOAD_GL(DeleteSync); // optional
+	WINX_LOAD_GL(Enable);
+	WINX_LOAD_GL(GetString);
+	WINX_LOAD_GL(GetStringi); // optional
+	WINX_LOAD_GL(DebugMessageCallback); // optional
+	WINX_LOAD_GL(DebugMessageControl); // optional
+	WINX_LOAD_GL(GenQueries);
+	WINX_LOAD_GL(DeleteQueries);
+	WINX_LOAD_GL(QueryCounter); // optional
+	WINX_LOAD_GL(GetQueryObjectiv);
+	WINX_LOAD_GL(GetQueryObjectui64v); // optional
+	#undef WINX_LOAD_GL
+
+	return winxGL.GetIntegerv && winxGL.ReadBuffer && winxGL.ReadPixels && winxGL.GenBuffers && winxGL.DeleteBuffers && winxGL.BindBuffer
+		&& winxGL.BufferData && winxGL.MapBufferRange && winxGL.UnmapBuffer && winxGL.BindFramebuffer && winxGL.Enable && winxGL.GetString
+		&& winxGL.GenQueries && winxGL.DeleteQueries && winxGL.GetQueryObjectiv;
+}
+
+static bool winxHasToken(const char* list, const char* name) {
+	const size_t length = strlen(name);
+
+	// a plain substring search would also match names that other names start with
+	for (const char* match = list; match && (match = strstr(match, name)); match += length) {
+		if ((match == list || match[-1] == ' ') && (match[length] == ' ' || match[length] == '\0')) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// glXGetProcAddress can return non-NULL pointers even for unsupported functions,
+// so check the context version and extension list before using optional functions
+static bool winxHasGLVersion(int major, int minor) {
+	GLint context_major = 0, context_minor = 0;
+
+	// legacy contexts don't know GL_MAJOR_VERSION and leave the values untouched
+	winxGL.GetIntegerv(GL_MAJOR_VERSION, &context_major);
+	winxGL.GetIntegerv(GL_MINOR_VERSION, &context_minor);
+
+	return context_major > major || (context_major == major && context_minor >= minor);
+}
+
+static bool winxHasGLExtension(const char* extension) {
+	GLint count = 0;
+
+	if (winxHasGLVersion(3, 0) && winxGL.GetStringi) {
+		winxGL.GetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+		for (GLint i = 0; i < count; i ++) {
+			if (strcmp((const char*) winxGL.GetStringi(GL_EXTENSIONS, i), extension) == 0) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// legacy contexts only have a single space separated string
+	return winxHasToken((const char*) winxGL.GetString(GL_EXTENSIONS), extension);
+}
+
+// number of frames a capture can lag behind
+#define WINX_CAPTURE_FRAMES 3
+
+// single pending frame capture
+typedef struct {
+	GLuint buffer;
+	GLsync fence;
+	int width;
+	int height;
+	bool pending;
+} WinxCaptureSlot;
+
+// frame capture state
+typedef struct {
+	int index;
+	bool sync;
+	WinxCaptureSlot slots[WINX_CAPTURE_FRAMES];
+	WinxCaptureEventHandle handle;
+
+	FILE* file;
+	int format;
+	int width;
+	int height;
+	unsigned char* frame;
+} WinxCaptureState;
+
+static WinxCaptureState* winxCaptureState = NULL;
+
+static void winxWriteCaptureFrame(int width, int height, const unsigned char* pixels) {
+	WinxCaptureState* capture = winxCaptureState;
+	const int size = capture->width * capture->height;
+
+	// files need a constant frame size, so crop or pad frames captured after a resize,
+	// OpenGL stores the rows bottom-up so also flip them while at it
+	for (int y = 0; y < capture->height; y ++) {
+		for (int x = 0; x < capture->width; x ++) {
+			const unsigned char black[4] = {0, 0, 0, 255};
+			const unsigned char* rgba = (x < width && y < height) ? pixels + ((height - y - 1) * width + x) * 4 : black;
+			const int i = y * capture->width + x;
+
+			if (capture->format == WINX_CAPTURE_Y4M) {
+				const int r = rgba[0], g = rgba[1], b = rgba[2];
+
+				// BT.601 (limited range) conversion to planar YUV 4:4:4
+				capture->frame[i] = (unsigned char) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+				capture->frame[i + size] = (unsigned char) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+				capture->frame[i + size * 2] = (unsigned char) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+			} else {
+				memcpy(capture->frame + i * 4, rgba, 4);
+			}
+		}
+	}
+
+	if (capture->format == WINX_CAPTURE_Y4M) {
+		fputs("FRAME\n", capture->file);
+		fwrite(capture->frame, 3, size, capture->file);
+	} else {
+		fwrite(capture->frame, 4, size, capture->file);
+	}
+}
+
+static void winxFinishCaptureSlot(WinxCaptureSlot* slot) {
+	if (slot->fence) {
+		winxGL.ClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		winxGL.DeleteSync(slot->fence);
+		slot->fence = NULL;
+	}
+
+	winxGL.BindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+	const unsigned char* pixels = (const unsigned char*) winxGL.MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot->width * slot->height * 4, GL_MAP_READ_BIT);
+
+	if (pixels) {
+		if (winxCaptureState->file) {
+			winxWriteCaptureFrame(slot->width, slot->height, pixels);
+		} else {
+			winxCaptureState->handle(slot->width, slot->height, pixels);
+		}
+
+		winxGL.UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+
+	slot->pending = false;
+}
+
+static bool winxIsCaptureSlotReady(WinxCaptureSlot* slot) {
+	if (!slot->fence) {
+		return true;
+	}
+
+	GLenum status = winxGL.ClientWaitSync(slot->fence, 0, 0);
+	return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+static void winxCaptureFrame() {
+	WinxCaptureState* capture = winxCaptureState;
+	WinxCaptureSlot* slot = capture->slots + capture->index;
+
+	GLint pack_buffer, read_framebuffer, read_buffer;
+	winxGL.GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pack_buffer);
+	winxGL.GetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_framebuffer);
+	winxGL.GetIntegerv(GL_READ_BUFFER, &read_buffer);
+
+	// this is the oldest slot, if it is still pending after going
+	// around the whole ring we have no choice but to wait for it
+	if (slot->pending) {
+		winxFinishCaptureSlot(slot);
+	}
+
+	winxGL.BindBuffer(GL_PIXEL_PACK_BUFFER, slot->buffer);
+
+	if (slot->width != winx->width || slot->height != winx->height) {
+		slot->width = winx->width;
+		slot->height = winx->height;
+		winxGL.BufferData(GL_PIXEL_PACK_BUFFER, slot->width * slot->height * 4, NULL, GL_STREAM_READ);
+	}
+
+	// start an asynchronous copy of the back buffer into the pixel buffer object
+	winxGL.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	winxGL.ReadBuffer(GL_BACK);
+	winxGL.ReadPixels(0, 0, slot->width, slot->height, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+	slot->fence = capture->sync ? winxGL.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) : NULL;
+	slot->pending = true;
+	capture->index = (capture->index + 1) % WINX_CAPTURE_FRAMES;
+
+	// deliver, in order, all older frames that are already done
+	for (int i = 0; i < WINX_CAPTURE_FRAMES - 1; i ++) {
+		WinxCaptureSlot* older = capture->slots + (capture->index + i) % WINX_CAPTURE_FRAMES;
+
+		if (older->pending && older->fence && winxIsCaptureSlotReady(older)) {
+			winxFinishCaptureSlot(older);
+			continue;
+		}
+
+		if (older->pending) {
+			break;
+		}
+	}
+
+	winxGL.BindBuffer(GL_PIXEL_PACK_BUFFER, pack_buffer);
+	winxGL.BindFramebuffer(GL_READ_FRAMEBUFFER, read_framebuffer);
+	winxGL.ReadBuffer(read_buffer);
+}
+
+static bool winxBeginCapture() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxStartCapture: No active winx context!";
+		return false;
+	}
+
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxStartCapture: Current window has no OpenGL context!";
+		return false;
+	}
+
+	winxStopCapture();
+
+	if (!winxLoadGL()) {
+		winxErrorMsg = (char*) "winxStartCapture: Failed to load OpenGL functions!";
+		return false;
+	}
+
+	winxCaptureState = (WinxCaptureState*) calloc(1, sizeof(WinxCaptureState));
+	winxCaptureState->sync = winxHasGLVersion(3, 2) || winxHasGLExtension("GL_ARB_sync");
+
+	for (int i = 0; i < WINX_CAPTURE_FRAMES; i ++) {
+		winxGL.GenBuffers(1, &winxCaptureState->slots[i].buffer);
+	}
+
+	return true;
+}
+
+void winxStartCapture(WinxCaptureEventHandle handle) {
+	if (winxBeginCapture()) {
+		winxCaptureState->handle = handle;
+	}
+}
+
+bool winxStartCaptureFile(const char* path, int format, int fps) {
+	FILE* file = fopen(path, "wb");
+
+	if (!file) {
+		winxErrorMsg = (char*) "fopen: Failed to open capture file!";
+		return false;
+	}
+
+	if (!winxBeginCapture()) {
+		fclose(file);
+		return false;
+	}
+
+	WinxCaptureState* capture = winxCaptureState;
+	capture->file = file;
+	capture->format = format;
+	capture->width = winx->width;
+	capture->height = winx->height;
+	capture->frame = (unsigned char*) malloc(capture->width * capture->height * 4);
+
+	if (format == WINX_CAPTURE_Y4M) {
+		fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", capture->width, capture->height, fps);
+	}
+
+	return true;
+}
+
+void winxStopCapture() {
+	WinxCaptureState* capture = winxCaptureState;
+
+	if (!capture) {
+		return;
+	}
+
+	GLint pack_buffer;
+	winxGL.GetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &pack_buffer);
+
+	// deliver all remaining frames in order
+	for (int i = 0; i < WINX_CAPTURE_FRAMES; i ++) {
+		WinxCaptureSlot* slot = capture->slots + (capture->index + i) % WINX_CAPTURE_FRAMES;
+
+		if (slot->pending) {
+			winxFinishCaptureSlot(slot);
+		}
+
+		winxGL.DeleteBuffers(1, &slot->buffer);
+	}
+
+	winxGL.BindBuffer(GL_PIXEL_PACK_BUFFER, pack_buffer);
+
+	if (capture->file) {
+		fclose(capture->file);
+	}
+
+	free(capture->frame);
+	free(capture);
+	winxCaptureState = NULL;
+}
+
+
+// single deduplicated debug message
+typedef struct {
+	WinxDebugMessage message;
+	unsigned int source;
+	int frame_count;
+} WinxDebugEntry;
+
+// debug output state
+typedef struct {
+	int filter;
+	int count;
+	int capacity;
+	WinxDebugEntry* entries;
+	WinxDebugMessage* messages;
+	WinxDebugEventHandle handle;
+} WinxDebugState;
+
+static WinxDebugState* winxDebugState = NULL;
+
+static int winxGetDebugType(GLenum type) {
+	switch (type) {
+		case GL_DEBUG_TYPE_ERROR: return WINX_DEBUG_ERROR;
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return WINX_DEBUG_DEPRECATED;
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return WINX_DEBUG_UNDEFINED;
+		case GL_DEBUG_TYPE_PORTABILITY: return WINX_DEBUG_PORTABILITY;
+		case GL_DEBUG_TYPE_PERFORMANCE: return WINX_DEBUG_PERFORMANCE;
+		default: return WINX_DEBUG_OTHER;
+	}
+}
+
+static int winxGetDebugSeverity(GLenum severity) {
+	switch (severity) {
+		case GL_DEBUG_SEVERITY_HIGH: return WINX_SEVERITY_HIGH;
+		case GL_DEBUG_SEVERITY_MEDIUM: return WINX_SEVERITY_MEDIUM;
+		case GL_DEBUG_SEVERITY_LOW: return WINX_SEVERITY_LOW;
+		default: return WINX_SEVERITY_NOTIFICATION;
+	}
+}
+
+static void APIENTRY winxDebugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* text, const void* user) {
+	WinxDebugState* debug = winxDebugState;
+	const int winx_type = winxGetDebugType(type);
+	const int winx_severity = winxGetDebugSeverity(severity);
+
+	if (!debug || !(debug->filter & winx_type)) {
+		return;
+	}
+
+	// the same few messages tend to repeat every frame, so only count them
+	for (int i = 0; i < debug->count; i ++) {
+		WinxDebugEntry* entry = debug->entries + i;
+
+		if (entry->message.id == id && entry->message.type == winx_type && entry->message.severity == winx_severity && entry->source == source) {
+			entry->message.count ++;
+			entry->frame_count ++;
+			return;
+		}
+	}
+
+	if (debug->count == debug->capacity) {
+		debug->capacity = debug->capacity ? debug->capacity * 2 : 16;
+		debug->entries = (WinxDebugEntry*) realloc(debug->entries, debug->capacity * sizeof(WinxDebugEntry));
+	}
+
+	// the length is not reliable with ARB_debug_output, but the text is always null terminated
+	char* copy = (char*) malloc(strlen(text) + 1);
+	strcpy(copy, text);
+
+	WinxDebugEntry* entry = debug->entries + (debug->count ++);
+	entry->source = source;
+	entry->frame_count = 1;
+	entry->message.id = id;
+	entry->message.type = winx_type;
+	entry->message.severity = winx_severity;
+	entry->message.count = 1;
+	entry->message.frame_count = 0;
+	entry->message.text = copy;
+
+	debug->handle(&entry->message);
+}
+
+static void winxInitDebug() {
+	if (!winxLoadGL()) {
+		return;
+	}
+
+	if (winxHasGLVersion(4, 3) || winxHasGLExtension("GL_KHR_debug")) {
+		winxGL.Enable(GL_DEBUG_OUTPUT);
+	} else if (winxHasGLExtension("GL_ARB_debug_output")) {
+		// the older extension is enabled by default and has no GL_DEBUG_OUTPUT toggle
+		*((void**) &winxGL.DebugMessageCallback) = winxGetProcAddress("glDebugMessageCallbackARB");
+		*((void**) &winxGL.DebugMessageControl) = winxGetProcAddress("glDebugMessageControlARB");
+	} else {
+		return;
+	}
+
+	winxDebugState = (WinxDebugState*) calloc(1, sizeof(WinxDebugState));
+	winxDebugState->filter = WINX_DEBUG_ALL;
+	winxDebugState->handle = WinxDummyDebugEventHandle;
+
+	// report messages on the thread that caused them, as they happen,
+	// so that the state can be accessed without additional locking
+	winxGL.Enable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	winxGL.DebugMessageCallback(winxDebugCallback, NULL);
+}
+
+static void winxFreeDebug() {
+	WinxDebugState* debug = winxDebugState;
+
+	if (!debug) {
+		return;
+	}
+
+	winxGL.DebugMessageCallback(NULL, NULL);
+
+	for (int i = 0; i < debug->count; i ++) {
+		free((char*) debug->entries[i].message.text);
+	}
+
+	free(debug->entries);
+	free(debug->messages);
+	free(debug);
+	winxDebugState = NULL;
+}
+
+static void winxEndDebugFrame() {
+	WinxDebugState* debug = winxDebugState;
+
+	for (int i = 0; i < debug->count; i ++) {
+		debug->entries[i].message.frame_count = debug->entries[i].frame_count;
+		debug->entries[i].frame_count = 0;
+	}
+}
+
+void winxSetDebugFilter(int types) {
+	if (!winxDebugState) {
+		winxErrorMsg = (char*) "winxSetDebugFilter: Debug output is not enabled!";
+		return;
+	}
+
+	winxDebugState->filter = types;
+
+	// also let the driver know, so that it can skip generating the filtered out messages
+	if (winxGL.DebugMessageControl) {
+		const GLenum gl_types[] = {GL_DEBUG_TYPE_ERROR, GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR, GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR, GL_DEBUG_TYPE_PORTABILITY, GL_DEBUG_TYPE_PERFORMANCE};
+
+		winxGL.DebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, NULL, (types & WINX_DEBUG_OTHER) ? GL_TRUE : GL_FALSE);
+
+		for (int i = 0; i < 5; i ++) {
+			winxGL.DebugMessageControl(GL_DONT_CARE, gl_types[i], GL_DONT_CARE, 0, NULL, (types & winxGetDebugType(gl_types[i])) ? GL_TRUE : GL_FALSE);
+		}
+	}
+}
+
+void winxSetDebugEventHandle(WinxDebugEventHandle handle) {
+	if (!winxDebugState) {
+		winxErrorMsg = (char*) "winxSetDebugEventHandle: Debug output is not enabled!";
+		return;
 	}
 
-	if (!SetPixelFormat(fakeDeviceContext, fakePixelFormat, &descriptor)) {
-		winxErrorMsg = (char*) "SetPixelFormat: Failed to select a pixel format!";
+	winxDebugState->handle = handle ? handle : WinxDummyDebugEventHandle;
+}
+
+const WinxDebugMessage* winxGetDebugMessages(int* count) {
+	WinxDebugState* debug = winxDebugState;
+
+	if (!debug) {
+		*count = 0;
+		return NULL;
+	}
+
+	// the entries hold some internal state, so copy the public parts into a separate array
+	debug->messages = (WinxDebugMessage*) realloc(debug->messages, debug->capacity * sizeof(WinxDebugMessage));
+
+	for (int i = 0; i < debug->count; i ++) {
+		debug->messages[i] = debug->entries[i].message;
+	}
+
+	*count = debug->count;
+	return debug->messages;
+}
+
+int winxGetDebugFrameCount(int types) {
+	WinxDebugState* debug = winxDebugState;
+	int total = 0;
+
+	if (debug) {
+		for (int i = 0; i < debug->count; i ++) {
+			if (debug->entries[i].message.type & types) {
+				total += debug->entries[i].message.frame_count;
+			}
+		}
+	}
+
+	return total;
+}
+
+// number of frames the GPU timings lag behind
+#define WINX_TIMING_FRAMES 4
+
+// maximum number of zones measured per frame
+#define WINX_TIMING_ZONES 32
+
+// GPU timestamps of a single frame, query 0 marks the start of the frame,
+// query 1 the end, and each zone uses one query for the start and one for the end
+typedef struct {
+	GLuint queries[2 + WINX_TIMING_ZONES * 2];
+	WinxGpuZone zones[WINX_TIMING_ZONES];
+	int zone_count;
+	bool pending;
+} WinxTimingSlot;
+
+// GPU timing state
+typedef struct {
+	int index;
+	int depth;
+	int stack[WINX_TIMING_ZONES];
+	double frame_time;
+	int zone_count;
+	WinxGpuZone zones[WINX_TIMING_ZONES];
+	WinxTimingSlot slots[WINX_TIMING_FRAMES];
+} WinxTimingState;
+
+static WinxTimingState* winxTimingState = NULL;
+
+static bool winxIsTimingSlotReady(WinxTimingSlot* slot) {
+	GLint available = 0;
+
+	// queries complete in order, so checking the end of the frame is enough
+	winxGL.GetQueryObjectiv(slot->queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+	return available;
+}
+
+static double winxGetTimingDelta(WinxTimingSlot* slot, int begin, int end) {
+	GLuint64 begin_time, end_time;
+
+	winxGL.GetQueryObjectui64v(slot->queries[begin], GL_QUERY_RESULT, &begin_time);
+	winxGL.GetQueryObjectui64v(slot->queries[end], GL_QUERY_RESULT, &end_time);
+
+	// timestamps are in nanoseconds
+	return (end_time - begin_time) / 1000000.0;
+}
+
+static void winxFinishTimingSlot(WinxTimingSlot* slot) {
+	WinxTimingState* timing = winxTimingState;
+
+	timing->frame_time = winxGetTimingDelta(slot, 0, 1);
+	timing->zone_count = slot->zone_count;
+
+	for (int i = 0; i < slot->zone_count; i ++) {
+		timing->zones[i] = slot->zones[i];
+		timing->zones[i].time = winxGetTimingDelta(slot, 2 + i * 2, 3 + i * 2);
+	}
+
+	slot->pending = false;
+}
+
+static void winxBeginTimingFrame() {
+	WinxTimingState* timing = winxTimingState;
+	WinxTimingSlot* slot = timing->slots + timing->index;
+
+	// this is the oldest slot, if it is still pending after going
+	// around the whole ring we have no choice but to wait for it
+	if (slot->pending) {
+		winxFinishTimingSlot(slot);
+	}
+
+	slot->zone_count = 0;
+	winxGL.QueryCounter(slot->queries[0], GL_TIMESTAMP);
+}
+
+static void winxEndTimingFrame() {
+	WinxTimingState* timing = winxTimingState;
+	WinxTimingSlot* slot = timing->slots + timing->index;
+
+	// zones can't span multiple frames, close the ones the user forgot about
+	while (timing->depth > 0) {
+		winxGpuZoneEnd();
+	}
+
+	winxGL.QueryCounter(slot->queries[1], GL_TIMESTAMP);
+	slot->pending = true;
+	timing->index = (timing->index + 1) % WINX_TIMING_FRAMES;
+
+	// read, in order, all older frames that are already done
+	for (int i = 0; i < WINX_TIMING_FRAMES - 1; i ++) {
+		WinxTimingSlot* older = timing->slots + (timing->index + i) % WINX_TIMING_FRAMES;
+
+		if (older->pending && winxIsTimingSlotReady(older)) {
+			winxFinishTimingSlot(older);
+			continue;
+		}
+
+		if (older->pending) {
+			break;
+		}
+	}
+
+	winxBeginTimingFrame();
+}
+
+bool winxStartGpuTiming() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxStartGpuTiming: No active winx context!";
 		return false;
 	}
 
-	fakeRenderContext = wglCreateContext(fakeDeviceContext);
-	if (!fakeRenderContext) {
-		winxErrorMsg = (char*) "wglCreateContext: Failed to create temporary render context!";
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxStartGpuTiming: Current window has no OpenGL context!";
 		return false;
 	}
 
-	// open real window
-	winx->hndl = CreateWindowA(clazz, title, WS_OVERLAPPEDWINDOW, 0, 0, width, height, NULL, NULL, hinstance, NULL);
-	if (!winx->hndl) {
-		winxErrorMsg = (char*) "CreateWindowA: Failed to create window!";
+	winxStopGpuTiming();
+
+	if (!winxLoadGL()) {
+		winxErrorMsg = (char*) "winxStartGpuTiming: Failed to load OpenGL functions!";
 		return false;
 	}
 
-	// create context
-	winx->device = GetDC(winx->hndl);
-	if (!winx->device) {
-		winxErrorMsg = (char*) "GetDC: Failed to create device context!";
+	if (!winxHasGLVersion(3, 3) && !winxHasGLExtension("GL_ARB_timer_query")) {
+		winxErrorMsg = (char*) "winxStartGpuTiming: Timer queries are not supported!";
 		return false;
 	}
 
-	PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB;
-	PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
+	winxTimingState = (WinxTimingState*) calloc(1, sizeof(WinxTimingState));
+	winxTimingState->frame_time = -1;
 
-	if (!wglMakeCurrent(fakeDeviceContext, fakeRenderContext)) {
-		winxErrorMsg = (char*) "wglMakeCurrent: Failed to select temporary context!";
+	for (int i = 0; i < WINX_TIMING_FRAMES; i ++) {
+		winxGL.GenQueries(2 + WINX_TIMING_ZONES * 2, winxTimingState->slots[i].queries);
+	}
+
+	winxBeginTimingFrame();
+	return true;
+}
+
+void winxStopGpuTiming() {
+	WinxTimingState* timing = winxTimingState;
+
+	if (!timing) {
+		return;
+	}
+
+	// the queries of the current frame were never ended, so they can't be waited on
+	for (int i = 0; i < WINX_TIMING_FRAMES; i ++) {
+		winxGL.DeleteQueries(2 + WINX_TIMING_ZONES * 2, timing->slots[i].queries);
+	}
+
+	free(timing);
+	winxTimingState = NULL;
+}
+
+void winxGpuZoneBegin(const char* name) {
+	WinxTimingState* timing = winxTimingState;
+
+	if (!timing) {
+		return;
+	}
+
+	WinxTimingSlot* slot = timing->slots + timing->index;
+
+	if (slot->zone_count == WINX_TIMING_ZONES || timing->depth == WINX_TIMING_ZONES) {
+		winxErrorMsg = (char*) "winxGpuZoneBegin: Too many zones in one frame!";
+		return;
+	}
+
+	const int zone = slot->zone_count ++;
+	strncpy(slot->zones[zone].name, name, sizeof(slot->zones[zone].name) - 1);
+	slot->zones[zone].name[sizeof(slot->zones[zone].name) - 1] = '\0';
+	slot->zones[zone].depth = timing->depth;
+	slot->zones[zone].time = 0;
+
+	timing->stack[timing->depth ++] = zone;
+	winxGL.QueryCounter(slot->queries[2 + zone * 2], GL_TIMESTAMP);
+}
+
+void winxGpuZoneEnd() {
+	WinxTimingState* timing = winxTimingState;
+
+	if (!timing) {
+		return;
+	}
+
+	if (timing->depth == 0) {
+		winxErrorMsg = (char*) "winxGpuZoneEnd: No zone to end!";
+		return;
+	}
+
+	WinxTimingSlot* slot = timing->slots + timing->index;
+	const int zone = timing->stack[-- timing->depth];
+
+	winxGL.QueryCounter(slot->queries[3 + zone * 2], GL_TIMESTAMP);
+}
+
+double winxGetGpuFrameTime() {
+	return winxTimingState ? winxTimingState->frame_time : -1;
+}
+
+const WinxGpuZone* winxGetGpuZones(int* count) {
+	WinxTimingState* timing = winxTimingState;
+
+	if (!timing) {
+		*count = 0;
+		return NULL;
+	}
+
+	*count = timing->zone_count;
+	return timing->zones;
+}
+
+bool winxGetContextInfo(WinxContextInfo* info) {
+	memset(info, 0, sizeof(WinxContextInfo));
+
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetContextInfo: No active winx context!";
 		return false;
 	}
 
-	wglChoosePixelFormatARB = (PFNWGLCHOOSEPIXELFORMATARBPROC) winxGetProc("wglChoosePixelFormatARB");
-	wglCreateContextAttribsARB = (PFNWGLCREATECONTEXTATTRIBSARBPROC) winxGetProc("wglCreateContextAttribsARB");
-	wglSwapIntervalEXT = (PFNWGLSWAPINTERVALEXTPROC) wglGetProcAddress("wglSwapIntervalEXT"); // optional
+	if (winx->mode != WINX_CONTEXT_OPENGL) {
+		winxErrorMsg = (char*) "winxGetContextInfo: Current window has no OpenGL context!";
+		return false;
+	}
 
-	if (winxErrorMsg != NULL) {
-		// winxGetProc set the error message
+	if (!winxLoadGL()) {
 		return false;
 	}
 
-	int pixelFormat;
-	BOOL status;
-	UINT numFormats;
+	// legacy contexts don't know the version enums and leave the values untouched
+	winxGL.GetIntegerv(GL_MAJOR_VERSION, &info->major);
+	winxGL.GetIntegerv(GL_MINOR_VERSION, &info->minor);
 
-	const int pixelAttribs[] = {
-		WGL_DRAW_TO_WINDOW_ARB, GL_TRUE,
-		WGL_SUPPORT_OPENGL_ARB, GL_TRUE,
-		WGL_DOUBLE_BUFFER_ARB, GL_TRUE,
-		WGL_PIXEL_TYPE_ARB, WGL_TYPE_RGBA_ARB,
-		WGL_ACCELERATION_ARB, WGL_FULL_ACCELERATION_ARB,
-		WGL_RED_BITS_ARB, __winx_hint_red_bits,
-		WGL_GREEN_BITS_ARB, __winx_hint_green_bits,
-		WGL_BLUE_BITS_ARB, __winx_hint_blue_bits,
-		WGL_ALPHA_BITS_ARB, __winx_hint_alpha_bits,
-		WGL_DEPTH_BITS_ARB, __winx_hint_depth_bits,
-		WGL_STENCIL_BITS_ARB, __winx_hint_stencil_bits,
-		WGL_SAMPLE_BUFFERS_ARB, __winx_hint_multisamples ? 1 : 0,
-		WGL_SAMPLES_ARB, __winx_hint_multisamples,
-		0
-	};
+	// a no-error context doesn't report unknown enums, so only ask for what the version has
+	if (winxHasGLVersion(3, 0)) {
+		GLint flags = 0;
+		winxGL.GetIntegerv(GL_CONTEXT_FLAGS, &flags);
 
-	int flags = 0;
+		info->debug = flags & GL_CONTEXT_FLAG_DEBUG_BIT;
+		info->robust = flags & GL_CONTEXT_FLAG_ROBUST_ACCESS_BIT;
+	}
 
-	if (__winx_hint_opengl_debug) flags |= WGL_CONTEXT_DEBUG_BIT_ARB;
-	if (__winx_hint_opengl_robust) flags |= WGL_CONTEXT_ROBUST_ACCESS_BIT_ARB;
+	if (winxHasGLVersion(3, 2)) {
+		GLint profile = 0;
+		winxGL.GetIntegerv(GL_CONTEXT_PROFILE_MASK, &profile);
 
-	int  contextAttributes[] = {
-		WGL_CONTEXT_MAJOR_VERSION_ARB, __winx_hint_opengl_major,
-		WGL_CONTEXT_MINOR_VERSION_ARB, __winx_hint_opengl_minor,
-		WGL_CONTEXT_PROFILE_MASK_ARB, __winx_hint_opengl_core ? WGL_CONTEXT_CORE_PROFILE_BIT_ARB : WGL_CONTEXT_COMPATIBILITY_PROFILE_BIT_ARB,
-		WGL_CONTEXT_FLAGS_ARB, flags,
-		0
-	};
+		info->core = profile & GL_CONTEXT_CORE_PROFILE_BIT;
+	}
 
-	status = wglChoosePixelFormatARB(winx->device, pixelAttribs, NULL, 1, &pixelFormat, &numFormats);
-	if (status && numFormats) {
+	// these are only known by the platform, they were either accepted when creating the context or dropped
+	info->no_error = winx->no_error;
+	info->release_none = winx->release_none;
+	info->srgb = winx->srgb;
 
-		PIXELFORMATDESCRIPTOR pfd;
-		memset(&pfd, 0, sizeof(PIXELFORMATDESCRIPTOR));
-		DescribePixelFormat(winx->device, pixelFormat, sizeof(PIXELFORMATDESCRIPTOR), &pfd);
+	return true;
+}
 
-		if (!SetPixelFormat(winx->device, pixelFormat, &pfd)) {
-			winxErrorMsg = (char*) "SetPixelFormat: Failed to select a pixel format!";
-			return false;
-		}
+static void winxInitGL() {
+#if defined(WINX_GL_LOADER)
+	if (__winx_hint_opengl_loader == WINX_LOADER_BATCH && !winxLoadGLFunctions()) {
+		winxErrorMsg = (char*) "winxLoadGLFunctions: Failed to load some OpenGL functions!";
+	}
+#endif
 
-		winx->context = wglCreateContextAttribsARB(winx->device, 0, contextAttributes);
-		if (!winx->context) {
-			winxErrorMsg = (char*) "wglCreateContextAttribsARB: Failed to create a render context!";
-			return false;
-		}
+	if (__winx_hint_opengl_debug) {
+		winxInitDebug();
+	}
+}
 
-	} else {
-		winxErrorMsg = (char*) "wglChoosePixelFormatARB: Failed to choose a pixel format!";
+static void winxEndFrame() {
+	if (winxCaptureState) {
+		winxCaptureFrame();
+	}
+
+	if (winxDebugState) {
+		winxEndDebugFrame();
+	}
+
+	if (winxTimingState) {
+		winxEndTimingFrame();
+	}
+}
+
+static void winxFreeGL() {
+	winxStopCapture();
+	winxStopGpuTiming();
+	winxFreeDebug();
+}
+
+
+void winxSetCursorEventHandle(WinxCursorEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetCursorEventHandle");
+	winx->cursor = handle ? handle : WinxDummyCursorEventHandle;
+	winxUpdateEventMask();
+}
+
+void winxSetButtonEventHandle(WinxButtonEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetButtonEventHandle");
+	winx->button = handle ? handle : WinxDummyButtonEventHandle;
+	winxUpdateEventMask();
+}
+
+void winxSetKeyboardEventHandle(WinxKeyboardEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetKeyboardEventHandle");
+	winx->keyboard = handle ? handle : WinxDummyKeyboardEventHandle;
+	winxUpdateEventMask();
+}
+
+void winxSetScrollEventHandle(WinxScrollEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetScrollEventHandle");
+	winx->scroll = handle ? handle : WinxDummyScrollEventHandle;
+	winxUpdateEventMask();
+}
+
+void winxSetCloseEventHandle(WinxCloseEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetCloseEventHandle");
+	winx->close = handle ? handle : WinxDummyCloseEventHandle;
+}
+
+void winxSetResizeEventHandle(WinxResizeEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetResizeEventHandle");
+	winx->resize = handle ? handle : WinxDummyResizeEventHandle;
+}
+
+void winxSetFocusEventHandle(WinxFocusEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetFocusEventHandle");
+	winx->focus = handle ? handle : WinxDummyFocusEventHandle;
+}
+
+void winxSetExposeEventHandle(WinxExposeEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetExposeEventHandle");
+	winx->expose = handle ? handle : WinxDummyExposeEventHandle;
+}
+
+void winxSetMonitorEventHandle(WinxMonitorEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetMonitorEventHandle");
+	winx->monitor_change = handle ? handle : WinxDummyMonitorEventHandle;
+}
+
+void winxSetVisibilityEventHandle(WinxVisibilityEventHandle handle) {
+	WINX_CONTEXT_ASSERT("winxSetVisibilityEventHandle");
+	winx->visibility = handle ? handle : WinxDummyVisibilityEventHandle;
+}
+
+void winxSetNativeEventHook(WinxNativeEventHandle handle, int order) {
+	WINX_CONTEXT_ASSERT("winxSetNativeEventHook");
+	winx->native = handle ? handle : WinxDummyNativeEventHandle;
+	winx->native_after = order == WINX_NATIVE_AFTER;
+}
+
+void winxResetEventHandles() {
+	WINX_CONTEXT_ASSERT("winxResetEventHandles");
+	winx->cursor = WinxDummyCursorEventHandle;
+	winx->button = WinxDummyButtonEventHandle;
+	winx->keyboard = WinxDummyKeyboardEventHandle;
+	winx->scroll = WinxDummyScrollEventHandle;
+	winx->close = WinxDummyCloseEventHandle;
+	winx->resize = WinxDummyResizeEventHandle;
+	winx->focus = WinxDummyFocusEventHandle;
+	winx->expose = WinxDummyExposeEventHandle;
+	winx->monitor_change = WinxDummyMonitorEventHandle;
+	winx->visibility = WinxDummyVisibilityEventHandle;
+	winx->native = WinxDummyNativeEventHandle;
+	winx->native_after = false;
+	winxUpdateEventMask();
+}
+
+bool winxGetRedraw() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetRedraw: No active winx context!";
 		return false;
 	}
 
-	// close temporary window
-	wglMakeCurrent(fakeDeviceContext, NULL);
-	wglDeleteContext(fakeRenderContext);
-	ReleaseDC(fakeHndl, fakeDeviceContext);
-	DestroyWindow(fakeHndl);
+	return WINX_GET_REDRAW();
+}
+
+void winxRequestRedraw() {
+	WINX_CONTEXT_ASSERT("winxRequestRedraw");
+	WINX_SET_REDRAW(true);
+}
+
+bool winxGetFocus() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetFocus: No active winx context!";
+		return false;
+	}
 
-	fakeDeviceContext = NULL;
-	fakeRenderContext = NULL;
-	fakeHndl = NULL;
+	return winx->focused;
+}
 
-	wglMakeCurrent(winx->device, winx->context);
+void winxGetWindowSize(int* width, int* height) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetWindowSize: No active winx context!";
+		*width = 0;
+		*height = 0;
+		return;
+	}
 
-	// set vsync
-	winxSetVsync(__winx_hint_vsync);
+	*width = winx->width;
+	*height = winx->height;
+}
 
-	// finish window creation
-	ShowWindow(winx->hndl, 1);
-	UpdateWindow(winx->hndl);
+void winxGetWindowPos(int* x, int* y) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetWindowPos: No active winx context!";
+		*x = 0;
+		*y = 0;
+		return;
+	}
 
-	return true;
+	*x = winx->x;
+	*y = winx->y;
 }
 
-void winxPollEvents() {
-	MSG event;
-
-	while (PeekMessageA(&event, NULL, 0, 0, PM_REMOVE)) {
-		TranslateMessage(&event);
-		DispatchMessage(&event);
+bool winxGetMapped() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetMapped: No active winx context!";
+		return false;
 	}
-}
 
-void winxSwapBuffers() {
-	SwapBuffers(winx->device);
+	return winx->mapped;
 }
 
-void winxClose() {
-	wglMakeCurrent(winx->device, NULL);
-	wglDeleteContext(winx->context);
-	ReleaseDC(winx->hndl, winx->device);
-	DestroyWindow(winx->hndl);
+bool winxGetVisible() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetVisible: No active winx context!";
+		return false;
+	}
 
-	free(winx);
-	winx = NULL;
+	return winx->visible;
 }
 
-void winxSetTitle(const char* title) {
-	WINX_CONTEXT_ASSERT("winxSetTitle");
+static void winxUpdateVisibility() {
+	const bool visible = winx->mapped && !winx->obscured && !winx->hidden;
 
-	SetWindowTextA(winx->hndl, title);
+	if (visible != winx->visible) {
+		winx->visible = visible;
+		WINX_SET_REDRAW(true);
+		winx->visibility(visible);
+	}
 }
 
-static HICON winxCreateIcon(int width, int height, unsigned char* buffer, bool is_icon, int x_hot, int y_hot) {
-	char* target = NULL;
-	BITMAPV5HEADER header = {0};
+static bool winxThrottleFrame() {
+	if (!winx->throttle || winx->visible) {
+		return false;
+	}
 
-	header.bV5Size        = sizeof(header);
-	header.bV5Width       = width;
-	header.bV5Height      = -height;
-	header.bV5Planes      = 1;
-	header.bV5BitCount    = 32;
-	header.bV5Compression = BI_BITFIELDS;
+	// the frame was still rendered, so it ends for the GPU timing and the debug counts, only nothing is presented or captured
+	if (winxDebugState) {
+		winxEndDebugFrame();
+	}
 
-	// the order needs to be presisly like that
-	// otherwise alpha doesn't work
-	header.bV5RedMask     = 0x00ff0000;
-	header.bV5GreenMask   = 0x0000ff00;
-	header.bV5BlueMask    = 0x000000ff;
-	header.bV5AlphaMask   = 0xff000000;
+	if (winxTimingState) {
+		winxEndTimingFrame();
+	}
 
-	HDC dc = GetDC(NULL);
+	// don't present frames of invisible windows, instead sleep until the next background frame is due
+	const double now = winxGetTime();
+	const double next = winx->throttle_time + 1.0 / winx->throttle;
 
-	if (!dc) {
-		winxErrorMsg = (char*) "GetDC: Failed to acquire drawable!";
-		return NULL;
+	if (next > now) {
+		winxSleep(next - now);
 	}
 
-	HBITMAP mask = CreateBitmap(width, height, 1, 1, NULL);
-	HBITMAP color = CreateDIBSection(dc, (BITMAPINFO*) &header, DIB_RGB_COLORS, (void**) &target, NULL, 0);
-	ReleaseDC(NULL, dc);
+	winx->throttle_time = next > now ? next : now;
+	return true;
+}
 
-	for (int i = 0; i < width * height;  i++) {
-		target[0] = buffer[0];
-		target[1] = buffer[1];
-		target[2] = buffer[2];
-		target[3] = buffer[3];
+// a timer added with winxAddTimer(), removed timers have no handle until they are cleaned up
+typedef struct {
+	int id;
+	double interval;
+	double time;
+	WinxTimerEventHandle handle;
+} WinxTimer;
 
-		target += 4;
-		buffer += 4;
+// a descriptor watched with winxWatchFd(), removed watches have the descriptor set to -1 until they are cleaned up
+typedef struct {
+	int fd;
+	int events;
+	int ready;
+	WinxWatchEventHandle handle;
+} WinxWatch;
+
+// timers and descriptor watches state
+typedef struct {
+	int timer_id;
+	int timer_count;
+	int timer_capacity;
+	WinxTimer* timers;
+	int watch_count;
+	int watch_capacity;
+	WinxWatch* watches;
+#if defined(WINX_GLX) || defined(WINX_WAYLAND)
+	struct pollfd* descriptors;
+#endif
+} WinxSourceState;
+
+static WinxSourceState* winxSourceState = NULL;
+
+static void winxInitSources() {
+	if (!winxSourceState) {
+		winxSourceState = (WinxSourceState*) calloc(1, sizeof(WinxSourceState));
 	}
+}
 
-	ICONINFO info = {0};
-	info.fIcon = is_icon;
-	info.xHotspot = x_hot;
-	info.yHotspot = y_hot;
-	info.hbmMask = mask;
-	info.hbmColor = color;
+int winxAddTimer(double interval, WinxTimerEventHandle handle) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxAddTimer: No active winx context!";
+		return 0;
+	}
 
-	HICON icon = CreateIconIndirect(&info);
+	if (interval <= 0 || !handle) {
+		winxErrorMsg = (char*) "winxAddTimer: Invalid timer interval or handle!";
+		return 0;
+	}
 
-	DeleteObject(color);
-	DeleteObject(mask);
+	winxInitSources();
+	WinxSourceState* state = winxSourceState;
 
-	if (!icon) {
-		winxErrorMsg = (char*) "CreateIconIndirect: Failed to create icon handle!";
-		return NULL;
+	if (state->timer_count == state->timer_capacity) {
+		state->timer_capacity = state->timer_capacity ? state->timer_capacity * 2 : 8;
+		state->timers = (WinxTimer*) realloc(state->timers, state->timer_capacity * sizeof(WinxTimer));
 	}
 
-	return icon;
+	WinxTimer* timer = state->timers + (state->timer_count ++);
+	timer->id = ++ state->timer_id;
+	timer->interval = interval;
+	timer->time = winxGetTime() + interval;
+	timer->handle = handle;
+
+	return timer->id;
 }
 
-void winxSetIcon(int width, int height, unsigned char* buffer) {
-	WINX_CONTEXT_ASSERT("winxSetIcon");
+void winxRemoveTimer(int timer) {
+	WINX_CONTEXT_ASSERT("winxRemoveTimer");
 
-	HICON largeIcon, smallIcon;
+	// only unset the handle, the timer could be removed from inside of the dispatch loop
+	for (int i = 0; winxSourceState && i < winxSourceState->timer_count; i ++) {
+		if (winxSourceState->timers[i].id == timer) {
+			winxSourceState->timers[i].handle = NULL;
+		}
+	}
+}
 
-	if (!buffer) {
+bool winxWatchFd(int fd, int events, WinxWatchEventHandle handle) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxWatchFd: No active winx context!";
+		return false;
+	}
 
-		largeIcon = (HICON) GetClassLongPtrW(winx->hndl, GCLP_HICON);
-        smallIcon = (HICON) GetClassLongPtrW(winx->hndl, GCLP_HICONSM);
+#if defined(WINX_GLX) || defined(WINX_WAYLAND)
+	if (fd < 0 || (events && !handle)) {
+		winxErrorMsg = (char*) "winxWatchFd: Invalid file descriptor or handle!";
+		return false;
+	}
 
-	} else {
+	winxInitSources();
+	WinxSourceState* state = winxSourceState;
 
-		HICON icon = winxCreateIcon(width, height, buffer, true, 0, 0);
+	// update the existing watch, this also removes it if no events are given
+	for (int i = 0; i < state->watch_count; i ++) {
+		WinxWatch* watch = state->watches + i;
 
-		if (icon == NULL) {
-			// don't set the error message as it must
-			// have been already set by winxCreateIcon
-			return;
+		if (watch->fd == fd) {
+			watch->fd = events ? fd : -1;
+			watch->events = events;
+			watch->ready = 0;
+			watch->handle = handle;
+			return true;
 		}
+	}
 
-		largeIcon = icon;
-		smallIcon = icon;
+	if (!events) {
+		return true;
+	}
 
+	if (state->watch_count == state->watch_capacity) {
+		state->watch_capacity = state->watch_capacity ? state->watch_capacity * 2 : 8;
+		state->watches = (WinxWatch*) realloc(state->watches, state->watch_capacity * sizeof(WinxWatch));
+
+		// one more for the display connection
+		state->descriptors = (struct pollfd*) realloc(state->descriptors, (state->watch_capacity + 1) * sizeof(struct pollfd));
 	}
 
-	SendMessage(winx->hndl, WM_SETICON, ICON_BIG, (LPARAM) largeIcon);
-	SendMessage(winx->hndl, WM_SETICON, ICON_SMALL, (LPARAM) smallIcon);
+	WinxWatch* watch = state->watches + (state->watch_count ++);
+	watch->fd = fd;
+	watch->events = events;
+	watch->ready = 0;
+	watch->handle = handle;
+
+	return true;
+#else
+	winxErrorMsg = (char*) "winxWatchFd: File descriptors can't be watched on this platform!";
+	return false;
+#endif
 }
 
-WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, int x, int y) {
-	if (buffer == NULL) {
-		return NULL;
-	}
+static double winxGetTimerWait() {
+	double wait = -1;
 
-	if (!winx) {
-		winxErrorMsg = (char*) "winxCreateCursorIcon: No active winx context!";
-		return NULL;
+	if (!winxSourceState) {
+		return wait;
 	}
 
-	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
-	cursor->native = winxCreateIcon(width, height, buffer, false, x, y);
+	const double now = winxGetTime();
 
-	return cursor;
-}
+	for (int i = 0; i < winxSourceState->timer_count; i ++) {
+		const WinxTimer* timer = winxSourceState->timers + i;
 
-WinxCursor* winxCreateNullCursorIcon() {
-	WinxCursor* cursor = (WinxCursor*) malloc(sizeof(WinxCursor));
-	cursor->native = NULL;
-	return cursor;
+		if (timer->handle && (wait < 0 || timer->time - now < wait)) {
+			wait = timer->time > now ? timer->time - now : 0;
+		}
+	}
+
+	return wait;
 }
 
-void winxDeleteCursorIcon(WinxCursor* cursor) {
-	if (cursor) {
-		if (cursor->native) {
-			DestroyIcon((HICON) cursor->native);
-		}
+#if defined(WINX_GLX) || defined(WINX_WAYLAND)
+static bool winxPollSources(int connection, int timeout) {
+	const int count = winxSourceState ? winxSourceState->watch_count : 0;
+	const double wait = winxGetTimerWait();
 
-		free(cursor);
+	// nothing to check without blocking
+	if (connection == -1 && count == 0 && timeout == 0) {
+		return false;
 	}
-}
 
-void winxSetVsync(int vsync) {
-	WINX_CONTEXT_ASSERT("winxSetVsync");
+	// wake up for the next timer, rounded up so that it is due by then
+	if (wait >= 0) {
+		const int millis = wait > 0 ? (int) (wait * 1000) + 1 : 0;
+		timeout = (timeout < 0 || millis < timeout) ? millis : timeout;
+	}
 
-	if (wglSwapIntervalEXT) {
-		wglSwapIntervalEXT(__winx_hint_vsync);
+	if (count == 0) {
+		struct pollfd descriptor = {connection, POLLIN, 0};
+		return poll(&descriptor, 1, timeout) > 0 && (descriptor.revents & POLLIN);
 	}
-}
 
-bool winxGetFocus() {
-	if (!winx) {
-		winxErrorMsg = (char*) "winxGetFocus: No active winx context!";
+	// poll() ignores negative descriptors, so removed watches and a missing connection can stay in the set
+	struct pollfd* descriptors = winxSourceState->descriptors;
+	descriptors[0].fd = connection;
+	descriptors[0].events = POLLIN;
+	descriptors[0].revents = 0;
+
+	for (int i = 0; i < count; i ++) {
+		const WinxWatch* watch = winxSourceState->watches + i;
+		descriptors[i + 1].fd = watch->fd;
+		descriptors[i + 1].events = ((watch->events & WINX_WATCH_READ) ? POLLIN : 0) | ((watch->events & WINX_WATCH_WRITE) ? POLLOUT : 0);
+		descriptors[i + 1].revents = 0;
+	}
+
+	if (poll(descriptors, count + 1, timeout) <= 0) {
 		return false;
 	}
 
-	return GetActiveWindow() == winx->hndl;
-}
+	// the handles are only called later by winxDispatchSources(), after the platform is done reading
+	for (int i = 0; i < count; i ++) {
+		const short revents = descriptors[i + 1].revents;
+		WinxWatch* watch = winxSourceState->watches + i;
 
-void winxSetFocus() {
-	WINX_CONTEXT_ASSERT("winxSetFocus");
+		watch->ready |= (revents & POLLIN) ? WINX_WATCH_READ : 0;
+		watch->ready |= (revents & POLLOUT) ? WINX_WATCH_WRITE : 0;
+		watch->ready |= (revents & (POLLERR | POLLHUP | POLLNVAL)) ? WINX_WATCH_ERROR : 0;
+	}
 
-	SetActiveWindow(winx->hndl);
-	SetForegroundWindow(winx->hndl);
-	SetFocus(winx->hndl);
+	return descriptors[0].revents & POLLIN;
 }
+#endif
 
-void winxSetCursorPos(int x, int y) {
-	WINX_CONTEXT_ASSERT("winxSetCursorPos");
+static void winxDispatchSources() {
+	if (!winxSourceState) {
+		return;
+	}
 
-	POINT pos = {x, y};
+	const double now = winxGetTime();
 
-	ClientToScreen(winx->hndl, &pos);
-	SetCursorPos(pos.x, pos.y);
-}
+	// the handles could add or remove sources or even call winxClose(), so access them by index
+	for (int i = 0; winxSourceState && i < winxSourceState->watch_count; i ++) {
+		WinxWatch* watch = winxSourceState->watches + i;
+		const int ready = watch->ready;
+		watch->ready = 0;
 
-double winxGetTime() {
-	if (!winx) {
-		winxErrorMsg = (char*) "winxGetTime: No active winx context!";
-		return 0;
+		if (watch->fd != -1 && ready) {
+			watch->handle(watch->fd, ready);
+		}
 	}
 
-	unsigned long long frequency, count;
-	QueryPerformanceFrequency((LARGE_INTEGER*) &frequency);
-	QueryPerformanceCounter((LARGE_INTEGER*) &count);
+	for (int i = 0; winxSourceState && i < winxSourceState->timer_count; i ++) {
+		WinxTimer* timer = winxSourceState->timers + i;
 
-	return (count - winx->time) / (double) frequency;
-}
+		if (timer->handle && timer->time <= now) {
 
-#endif // WINAPI
+			// skip the calls that were missed, instead of making them all at once
+			timer->time += timer->interval;
 
-void winxSetCursorEventHandle(WinxCursorEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetCursorEventHandle");
-	winx->cursor = handle ? handle : WinxDummyCursorEventHandle;
-}
+			if (timer->time <= now) {
+				timer->time = now + timer->interval;
+			}
 
-void winxSetButtonEventHandle(WinxButtonEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetButtonEventHandle");
-	winx->button = handle ? handle : WinxDummyButtonEventHandle;
-}
+			timer->handle(timer->id);
+		}
+	}
 
-void winxSetKeyboardEventHandle(WinxKeyboardEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetKeyboardEventHandle");
-	winx->keyboard = handle ? handle : WinxDummyKeyboardEventHandle;
-}
+	if (!winxSourceState) {
+		return;
+	}
 
-void winxSetScrollEventHandle(WinxScrollEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetScrollEventHandle");
-	winx->scroll = handle ? handle : WinxDummyScrollEventHandle;
-}
+	// clean up the removed sources now that nothing iterates them
+	int timers = 0, watches = 0;
 
-void winxSetCloseEventHandle(WinxCloseEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetCloseEventHandle");
-	winx->close = handle ? handle : WinxDummyCloseEventHandle;
+	for (int i = 0; i < winxSourceState->timer_count; i ++) {
+		if (winxSourceState->timers[i].handle) {
+			winxSourceState->timers[timers ++] = winxSourceState->timers[i];
+		}
+	}
+
+	for (int i = 0; i < winxSourceState->watch_count; i ++) {
+		if (winxSourceState->watches[i].fd != -1) {
+			winxSourceState->watches[watches ++] = winxSourceState->watches[i];
+		}
+	}
+
+	winxSourceState->timer_count = timers;
+	winxSourceState->watch_count = watches;
 }
 
-void winxSetResizeEventHandle(WinxResizeEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetResizeEventHandle");
-	winx->resize = handle ? handle : WinxDummyResizeEventHandle;
+static void winxFreeSources() {
+	if (winxSourceState) {
+		free(winxSourceState->timers);
+		free(winxSourceState->watches);
+#if defined(WINX_GLX) || defined(WINX_WAYLAND)
+		free(winxSourceState->descriptors);
+#endif
+		free(winxSourceState);
+		winxSourceState = NULL;
+	}
 }
 
-void winxSetFocusEventHandle(WinxFocusEventHandle handle) {
-	WINX_CONTEXT_ASSERT("winxSetFocusEventHandle");
-	winx->focus = handle ? handle : WinxDummyFocusEventHandle;
+const WinxMonitor* winxGetMonitors(int* count) {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetMonitors: No active winx context!";
+		*count = 0;
+		return NULL;
+	}
+
+	*count = winx->monitor_count;
+	return winx->monitors;
 }
 
-void winxResetEventHandles() {
-	WINX_CONTEXT_ASSERT("winxResetEventHandles");
-	winx->cursor = WinxDummyCursorEventHandle;
-	winx->button = WinxDummyButtonEventHandle;
-	winx->keyboard = WinxDummyKeyboardEventHandle;
-	winx->scroll = WinxDummyScrollEventHandle;
-	winx->close = WinxDummyCloseEventHandle;
-	winx->resize = WinxDummyResizeEventHandle;
-	winx->focus = WinxDummyFocusEventHandle;
+int winxGetWindowMonitor() {
+	if (!winx) {
+		winxErrorMsg = (char*) "winxGetWindowMonitor: No active winx context!";
+		return 0;
+	}
+
+	return winx->monitor;
 }
 
 void winxSetCursorCapture(bool captured) {
@@ -1086,7 +6629,7 @@ void winxSetCursorCapture(bool captured) {
 	winx->capture = captured;
 
 	// if the window is not focused the even loop will set/unset it later
-	if (winxGetFocus()) {
+	if (winx->focused) {
 		winxUpdateCursorState(winx->capture, winx->cursor_icon);
 	}
 }
@@ -1096,7 +6639,43 @@ void winxSetCursorIcon(WinxCursor* cursor) {
 	winx->cursor_icon = cursor;
 
 	// if the window is not focused the even loop will set/unset it later
-	if (winxGetFocus()) {
+	if (winx->focused) {
 		winxUpdateCursorState(winx->capture, winx->cursor_icon);
 	}
 }
+
+static void winxTrackCursor(WinxCursor* cursor) {
+	cursor->next = winx->cursors;
+	winx->cursors = cursor;
+}
+
+static bool winxUntrackCursor(WinxCursor* cursor) {
+	for (WinxCursor** link = &winx->cursors; *link; link = &(*link)->next) {
+		if (*link == cursor) {
+			*link = cursor->next;
+
+			// don't leave the window with a deleted icon
+			if (winx->cursor_icon == cursor) {
+				winxSetCursorIcon(NULL);
+			}
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void winxFreeCursors() {
+
+	// only touch the pointer if it was changed, winxOpen() could have failed before there even is one
+	if (winx->capture || winx->cursor_icon) {
+		winx->capture = false;
+		winx->cursor_icon = NULL;
+		winxUpdateCursorState(false, NULL);
+	}
+
+	while (winx->cursors) {
+		winxDeleteCursorIcon(winx->cursors);
+	}
+}
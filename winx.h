@@ -56,6 +56,65 @@
  *	}
  *
  *	To close the window call 'winxClose'. Note that this doesn't reset any modified window hints!
+ *
+ *	To only render when something changed set the WINX_HINT_LAZY hint, 'winxPollEvents' will then block until 'winxGetRedraw'
+ *	returns true, you can keep such loop running using 'winxRequestRedraw' (for example to play an animation).
+ *
+ *	When built with the WINX_GL_LOADER CMake option WINX also generates an OpenGL loader (winx_gl.h) from the Khronos registry,
+ *	covering the version and extensions selected with WINX_GL_VERSION, WINX_GL_PROFILE and WINX_GL_EXTENSIONS. Include it instead of
+ *	other OpenGL headers, its functions resolve themselves on their first call, or all at once in 'winxOpen' if the
+ *	WINX_HINT_OPENGL_LOADER hint is set to WINX_LOADER_BATCH.
+ *
+ *	To open and close windows repeatedly set the WINX_HINT_PERSISTENT hint, with WINX_PERSISTENT_DISPLAY 'winxClose' keeps the
+ *	X11 display connection and the chosen frame buffer config for the next 'winxOpen', with WINX_PERSISTENT_WINDOW it also only
+ *	hides the window and keeps its context. The kept state is only reused if the relevant hints didn't change, otherwise it is
+ *	recreated. Call 'winxTerminate' after the last 'winxClose' to release it. This hint has no effect on Windows.
+ *
+ *	To save power while the window can't be seen set the WINX_HINT_THROTTLE hint to a background frame rate (like 5), while
+ *	'winxGetVisible' returns false 'winxSwapBuffers' will then not present anything and instead sleep to limit the render loop
+ *	to that rate. Use 'winxSetVisibilityEventHandle' to also pause other work.
+ *
+ *	Some context features are only requested if the driver supports them, and 'winxOpen' falls back to a context without them
+ *	otherwise. WINX_HINT_OPENGL_NO_ERROR skips the driver's error checking (ignored together with the debug or robust hints),
+ *	WINX_HINT_OPENGL_RELEASE set to WINX_RELEASE_NONE stops the driver from flushing when the context is released (useful
+ *	when moving the context between threads), and WINX_HINT_SRGB asks for an sRGB capable framebuffer (enable GL_FRAMEBUFFER_SRGB
+ *	to use it). Call 'winxGetContextInfo' to check which of them were applied.
+ *
+ *	For touch screens and pens set the WINX_HINT_INPUT_SAMPLES hint, each 'winxPollEvents' then collects all samples that
+ *	arrived since the previous one (with sub-pixel positions, pressure and tilt), read them with 'winxGetInputSamples'.
+ *	Touches are then no longer reported as mouse clicks. This uses XInput2 and is currently only supported on X11.
+ *
+ *	To draw on the CPU instead of using OpenGL set the WINX_HINT_CONTEXT hint to WINX_CONTEXT_SOFTWARE, such window
+ *	has no OpenGL context, instead draw into the buffer returned by 'winxGetPixels' and present it with 'winxPresentPixels'.
+ *
+ *	To render with Vulkan set the WINX_HINT_CONTEXT hint to WINX_CONTEXT_NONE, create the VkInstance with the extensions
+ *	returned by 'winxGetRequiredVulkanInstanceExtensions' and then the VkSurfaceKHR for the window using 'winxCreateVulkanSurface'.
+ *	The Vulkan loader is opened at runtime, so WINX doesn't need to be linked against it. 'winxSwapBuffers' presents nothing
+ *	in this mode, but can still be called to throttle invisible windows (see WINX_HINT_THROTTLE).
+ *
+ *	The OpenGL context is made current on the thread that called 'winxOpen', to render on a different thread call
+ *	'winxReleaseContext' on the opening thread and then 'winxMakeContextCurrent' on the render thread. The render thread can
+ *	then call OpenGL functions and 'winxSwapBuffers' (or 'winxSwapBuffersWithDamage'), while all other WINX functions,
+ *	including 'winxPollEvents' and the event handlers it calls, stay on the thread that opened the window. This way the
+ *	window keeps responding to the window manager (moving, resizing) even when a frame takes long to render.
+ *	Before calling 'winxClose' release the context on the render thread and make sure it no longer calls 'winxSwapBuffers',
+ *	'winxClose' then makes the context current on the closing thread to free the resources WINX created in it.
+ *
+ *	To handle sockets and other work on the same thread as the window use 'winxWatchFd' and 'winxAddTimer', their handles are
+ *	called from 'winxPollEvents' and 'winxWaitEvents', which also wake up for them (even in lazy mode), so there is no need for
+ *	a second thread or busy polling. Request a redraw from such handle if the window needs to show the change.
+ *
+ *	Events WINX doesn't handle itself (like RandR or XInput events of other devices) can be read with 'winxSetNativeEventHook',
+ *	which passes each native event to the given handle, together with 'winxGetNativeDisplay' this avoids opening a second
+ *	connection just for them. Select the extra events on the display returned by it, the hook then receives them from the
+ *	regular 'winxPollEvents' loop. On Wayland the hook is never called, as there events are delivered to protocol listeners.
+ *	In the null backend the hook receives the 'WinxNullEvent' pushed with 'winxNullPushEvent'.
+ *
+ *	For unit tests and CPU-only benchmarks build with WINX_NULL defined (the WINX_NULL CMake option), WINX then talks to no
+ *	window system at all. Events are queued with 'winxNullPushEvent' and dispatched by the next 'winxPollEvents', 'winxGetTime'
+ *	returns a fake time that only advances on swaps (by the interval set with 'winxNullSetSwapInterval'), lazy polls waiting
+ *	for timers, throttled swaps and 'winxNullAdvanceTime', so runs are fully deterministic. Software windows get a real pixel
+ *	buffer, OpenGL windows have no context and 'winxGetProcAddress' always returns NULL.
  */
 
 #ifndef WINX_H
@@ -73,6 +132,57 @@ extern "C" {
 
 typedef struct WinxCursor_s WinxCursor;
 
+typedef struct {
+	char name[32];
+	int x, y;
+	int width, height;
+	double refresh;
+	bool primary;
+} WinxMonitor;
+
+typedef struct {
+	int major, minor;
+	bool core;
+	bool debug;
+	bool robust;
+	bool no_error;
+	bool release_none;
+	bool srgb;
+} WinxContextInfo;
+
+typedef struct {
+	int source; // WINX_SOURCE_TOUCH or WINX_SOURCE_PEN
+	int state; // WINX_PRESSED, WINX_MOVED or WINX_RELEASED
+	int id; // touch point for touches, device for pens
+	double x, y; // in window pixels, with sub-pixel precision
+	double pressure; // from 0 to 1
+	double tilt_x, tilt_y; // from -1 to 1
+	double time; // in seconds, only the difference between samples is meaningful
+} WinxInputSample;
+
+typedef struct {
+	int type; // one of WINX_NULL_*
+	int state; // for buttons, keys, focus and visibility
+	int code; // button, key, scroll or monitor
+	int x, y; // for cursor and expose events
+	int width, height; // for resize and expose events
+} WinxNullEvent;
+
+typedef struct {
+	unsigned int id;
+	int type;
+	int severity;
+	int count;
+	int frame_count;
+	const char* text;
+} WinxDebugMessage;
+
+typedef struct {
+	char name[32];
+	int depth;
+	double time;
+} WinxGpuZone;
+
 typedef void (*WinxCursorEventHandle)(int x, int y);
 typedef void (*WinxButtonEventHandle)(int state, int button);
 typedef void (*WinxKeyboardEventHandle)(int state, int keycode);
@@ -80,6 +190,14 @@ typedef void (*WinxScrollEventHandle)(int scroll);
 typedef void (*WinxCloseEventHandle)(void);
 typedef void (*WinxResizeEventHandle)(int width, int height);
 typedef void (*WinxFocusEventHandle)(bool focused);
+typedef void (*WinxExposeEventHandle)(int x, int y, int width, int height);
+typedef void (*WinxMonitorEventHandle)(int monitor);
+typedef void (*WinxVisibilityEventHandle)(bool visible);
+typedef void (*WinxCaptureEventHandle)(int width, int height, const unsigned char* pixels);
+typedef void (*WinxDebugEventHandle)(const WinxDebugMessage* message);
+typedef void (*WinxTimerEventHandle)(int timer);
+typedef void (*WinxWatchEventHandle)(int fd, int events);
+typedef bool (*WinxNativeEventHandle)(void* event);
 
 /// set a window hint
 /// has to be called prior to winxOpen()
@@ -97,14 +215,54 @@ bool winxOpen(int width, int height, const char* title);
 /// this will call the registered event handlers
 void winxPollEvents();
 
+/// wait for at least one event and process it
+/// this will block the calling thread until there are events to process
+void winxWaitEvents();
+
+/// make the OpenGL context of the current window current on the calling thread
+/// it must first be released with winxReleaseContext() on the thread it was current on
+void winxMakeContextCurrent();
+
+/// release the OpenGL context of the current window from the calling thread
+/// after this call no OpenGL context is current on the calling thread
+void winxReleaseContext();
+
 /// swap display buffers
 /// this needs to be called every frame
 void winxSwapBuffers();
 
-/// used to close current window
+/// present only the given regions of the back buffer, rects is an array of count {x, y, width, height}
+/// quads (with the origin in the top-left corner), falls back to winxSwapBuffers() if not supported
+void winxSwapBuffersWithDamage(const int* rects, int count);
+
+/// check if winxSwapBuffersWithDamage() can present partial frames for the current window
+/// if it can the back buffer is preserved between frames, otherwise its contents are undefined after a swap
+bool winxGetDamageSupport();
+
+/// get the time (as returned by winxGetTime()) at which the last presented frame was shown and the display refresh interval
+/// returns false if the backend doesn't report presentation timing (currently only the Wayland backend does) or no frame was shown yet
+bool winxGetPresentTiming(double* time, double* interval);
+
+/// get the touch and pen samples received by the last winxPollEvents() or winxWaitEvents(), in the order they arrived
+/// needs the WINX_HINT_INPUT_SAMPLES hint, the array is only valid until the next call to one of those functions
+const WinxInputSample* winxGetInputSamples(int* count);
+
+/// get the pixel buffer of a window opened with WINX_HINT_CONTEXT set to WINX_CONTEXT_SOFTWARE
+/// each pixel is a 0x00RRGGBB value, rows are window width long, the pointer can change after a swap or resize
+unsigned int* winxGetPixels();
+
+/// present the given regions (in the same format as in winxSwapBuffersWithDamage()) of the pixel buffer
+/// pass NULL to present the whole buffer, calling winxSwapBuffers() on a software window does the same
+void winxPresentPixels(const int* rects, int count);
+
+/// used to close current window, also deletes all cursor icons and timers
 /// this resets all internal state apart from the window hints
 void winxClose();
 
+/// release the display connection (and window) kept alive by winxClose() with the WINX_HINT_PERSISTENT hint
+/// has to be called after winxClose(), does nothing if nothing was kept alive
+void winxTerminate();
+
 /// set title for current window
 /// UTF-8 strings should be supported by this function
 void winxSetTitle(const char* title);
@@ -113,14 +271,34 @@ void winxSetTitle(const char* title);
 /// pass WINX_ICON_DEFAULT as buffer to reset the icon (width and height will be ignored)
 void winxSetIcon(int width, int height, unsigned char* buffer);
 
+/// switch the current window in or out of fullscreen mode
+/// while in fullscreen the compositor is asked to stop compositing the window
+void winxSetFullscreen(bool fullscreen);
+
 /// set desired vsync behaviour for current window
 /// use one of WINX_VSYNC_DISABLED, WINX_VSYNC_ENABLED, or WINX_VSYNC_ADAPTIVE
 void winxSetVsync(int vsync);
 
-/// check if the current window is focused
+/// check if the current window is focused, the state is tracked from window events so this is cheap to call every frame
 /// you can also register a focus event handle using winxSetFocusEventHandle()
 bool winxGetFocus();
 
+/// get the size of the current window, as of the last winxPollEvents()
+/// you can also register a resize event handle using winxSetResizeEventHandle()
+void winxGetWindowSize(int* width, int* height);
+
+/// get the position of the current window on the screen, as of the last winxPollEvents()
+/// the position is only known once the window manager has placed the window
+void winxGetWindowPos(int* x, int* y);
+
+/// check if the current window is mapped (shown and not minimized), as of the last winxPollEvents()
+/// a window is not mapped right after winxOpen() until the window manager shows it
+bool winxGetMapped();
+
+/// check if any part of the current window is visible, as of the last winxPollEvents()
+/// this is false for unmapped, minimized and fully covered windows (where the system reports it)
+bool winxGetVisible();
+
 /// focus the current window
 /// this call is not guaranteed to be respected by the system
 void winxSetFocus();
@@ -137,7 +315,7 @@ WinxCursor* winxCreateCursorIcon(int width, int height, unsigned char* buffer, i
 /// a helper method for creating an fully transparent cursor icon
 WinxCursor* winxCreateNullCursorIcon();
 
-/// free the allocated icon
+/// free the allocated icon, icons that are still alive get deleted by winxClose()
 /// deletes system resources associated with the icon if needed
 void winxDeleteCursorIcon(WinxCursor* cursor);
 
@@ -157,8 +335,8 @@ void winxSetCursorEventHandle(WinxCursorEventHandle handle);
 /// pass NULL to unset the associated event handler (if any)
 void winxSetButtonEventHandle(WinxButtonEventHandle handle);
 
-/// set the handle for keyboard events for current window
-/// pass NULL to unset the associated event handler (if any)
+/// set the handle for keyboard events for current window, the state is one of WINX_PRESSED, WINX_RELEASED
+/// or WINX_REPEATED (for keys held down), pass NULL to unset the associated event handler (if any)
 void winxSetKeyboardEventHandle(WinxKeyboardEventHandle handle);
 
 /// set the handle for cursor scroll for current window
@@ -177,17 +355,165 @@ void winxSetResizeEventHandle(WinxResizeEventHandle handle);
 /// pass NULL to unset the associated event handler (if any)
 void winxSetFocusEventHandle(WinxFocusEventHandle handle);
 
+/// set the handle for window expose events for current window
+/// pass NULL to unset the associated event handler (if any)
+void winxSetExposeEventHandle(WinxExposeEventHandle handle);
+
+/// set the handle for monitor change events for current window, called when the window moves
+/// to a different monitor or the monitor configuration changes, pass NULL to unset the associated event handler (if any)
+void winxSetMonitorEventHandle(WinxMonitorEventHandle handle);
+
+/// set the handle for visibility events for current window, called when the window gets minimized, fully covered or shown again
+/// use it to pause heavy work while nothing can be seen, pass NULL to unset the associated event handler (if any)
+void winxSetVisibilityEventHandle(WinxVisibilityEventHandle handle);
+
+/// call the handle with every native event of the current window (XEvent* on X11, MSG* on Windows), before or after winx
+/// handles it (WINX_NATIVE_BEFORE or WINX_NATIVE_AFTER), if called before returning true hides the event from winx
+void winxSetNativeEventHook(WinxNativeEventHandle handle, int order);
+
 /// reset all even handles for current window
 /// you can also pass NULL to a specific event handler setter to reset it
 void winxResetEventHandles();
 
+/// check if the current window needs to be redrawn
+/// set by expose, resize, focus and input events (and winxRequestRedraw()), cleared by winxSwapBuffers()
+bool winxGetRedraw();
+
+/// mark the current window as needing to be redrawn
+/// a lazy winxPollEvents() returns right away if this was called (for example during an animation)
+void winxRequestRedraw();
+
+/// call the handle every given number of seconds from winxPollEvents() and winxWaitEvents(), both wait for it
+/// returns the timer id (never 0) for winxRemoveTimer(), missed calls are skipped instead of being made up
+int winxAddTimer(double interval, WinxTimerEventHandle handle);
+
+/// stop a timer returned by winxAddTimer(), can be called from any handle (including the timer's own)
+/// all timers and watches are removed by winxClose()
+void winxRemoveTimer(int timer);
+
+/// call the handle from winxPollEvents() and winxWaitEvents() when the file descriptor is ready, both wait for it
+/// events is a mask of WINX_WATCH_READ and WINX_WATCH_WRITE (0 stops watching), not supported on Windows
+bool winxWatchFd(int fd, int events, WinxWatchEventHandle handle);
+
+/// get the list of connected monitors, with their geometry in pixels and exact refresh rates in Hz
+/// the returned array is owned by winx and is only valid until the next monitor change event
+const WinxMonitor* winxGetMonitors(int* count);
+
+/// get the index (in the winxGetMonitors() list) of the monitor the current window is on
+/// you can also register a monitor event handle using winxSetMonitorEventHandle()
+int winxGetWindowMonitor();
+
+/// get the version and flags of the current window's OpenGL context, including which of the optional context hints were applied
+/// must be called with the context current, returns false if the window has no OpenGL context
+bool winxGetContextInfo(WinxContextInfo* info);
+
+/// get the address of an OpenGL function for the current context
+/// returns NULL if the function is not available, can be passed to loaders like GLAD
+void* winxGetProcAddress(const char* name);
+
+#if defined(WINX_GL_LOADER)
+/// resolve all functions of the built-in OpenGL loader (winx_gl.h) right away, instead of on their first call
+/// returns false if some of the core functions are missing, called by winxOpen() with WINX_LOADER_BATCH
+bool winxLoadGLFunctions();
+#endif
+
+/// get the Vulkan instance extensions needed by winxCreateVulkanSurface(), can be called before winxOpen()
+/// returns NULL if the Vulkan loader is not available, the returned list is static and must not be freed
+const char** winxGetRequiredVulkanInstanceExtensions(int* count);
+
+/// create a Vulkan surface for the current window, instance is a VkInstance, allocator an optional VkAllocationCallbacks
+/// pointer and surface points to the VkSurfaceKHR to write, returns false on failure (see winxGetError())
+bool winxCreateVulkanSurface(void* instance, const void* allocator, void* surface);
+
+/// start capturing the frames presented by winxSwapBuffers(), the frames are read back asynchronously
+/// and passed to the handle a few frames later as RGBA pixels, stored bottom-up like in glReadPixels()
+void winxStartCapture(WinxCaptureEventHandle handle);
+
+/// start capturing the frames presented by winxSwapBuffers() into a file
+/// use WINX_CAPTURE_RAW or WINX_CAPTURE_Y4M as format, the fps is only used by WINX_CAPTURE_Y4M
+bool winxStartCaptureFile(const char* path, int format, int fps);
+
+/// stop the capture started with winxStartCapture() or winxStartCaptureFile()
+/// this will wait for and deliver all remaining frames, needs to be called on the thread that renders
+void winxStopCapture();
+
+/// select which types of OpenGL debug messages (WINX_DEBUG_*) should be collected, by default all are
+/// requires the WINX_HINT_OPENGL_DEBUG hint, use WINX_DEBUG_PERFORMANCE to only collect driver performance warnings
+void winxSetDebugFilter(int types);
+
+/// set the handle called the first time each unique OpenGL debug message is reported
+/// repeated messages are only counted, pass NULL to unset the associated event handler (if any)
+void winxSetDebugEventHandle(WinxDebugEventHandle handle);
+
+/// get all unique OpenGL debug messages reported so far, with the total number of times they were reported
+/// and the number of times they were reported during the last frame, the array is valid until the next call
+const WinxDebugMessage* winxGetDebugMessages(int* count);
+
+/// get the number of OpenGL debug messages of the given types (WINX_DEBUG_*) reported during the last frame
+/// a cheap way of checking for new driver warnings every frame
+int winxGetDebugFrameCount(int types);
+
+/// start measuring how long the GPU takes to execute each frame presented by winxSwapBuffers()
+/// the timings are read back a few frames later without stalling, requires OpenGL 3.3 or ARB_timer_query
+bool winxStartGpuTiming();
+
+/// stop measuring the GPU frame times started with winxStartGpuTiming()
+/// needs to be called on the thread that renders
+void winxStopGpuTiming();
+
+/// begin a named GPU timing zone, used to measure parts of a frame, zones can be nested
+/// does nothing if winxStartGpuTiming() wasn't called, the name can be at most 31 characters long
+void winxGpuZoneBegin(const char* name);
+
+/// end the GPU timing zone started last with winxGpuZoneBegin()
+/// zones still open when the frame is presented are ended automatically
+void winxGpuZoneEnd();
+
+/// get the GPU time, in milliseconds, between the two swaps of the most recent frame with available timings
+/// this includes time the GPU spent waiting for commands, returns -1 if no frame has been measured yet
+double winxGetGpuFrameTime();
+
+/// get the zones, with their GPU times in milliseconds, measured in the same frame as winxGetGpuFrameTime()
+/// the zones are listed in the order they were started, the array is valid until the next frame
+const WinxGpuZone* winxGetGpuZones(int* count);
+
+/// get the connection used by the current window, the Display* on X11, wl_display* on Wayland and HDC on Windows
+/// use it instead of opening a second connection, but don't close it or read events from it
+void* winxGetNativeDisplay();
+
+/// get the native handle of the current window, the Window on X11 (cast to a pointer), wl_surface* on Wayland and HWND on Windows
+/// both return NULL in the null backend
+void* winxGetNativeWindow();
+
 /// return a time in seconds since the winxOpen() was called (if successful)
 /// this function emulates the behaviour of glfwGetTime()
 double winxGetTime();
 
+#if defined(WINX_NULL)
+/// queue a fake event, it will be dispatched by the next winxPollEvents() or winxWaitEvents()
+/// only available in the null backend, the event is copied
+void winxNullPushEvent(const WinxNullEvent* event);
+
+/// set how much time each presented frame takes, 1/60 of a second by default
+/// only available in the null backend, the time returned by winxGetTime() advances by it on each swap
+void winxNullSetSwapInterval(double seconds);
+
+/// let the fake time pass, as returned by winxGetTime()
+/// only available in the null backend, the time never advances on its own
+void winxNullAdvanceTime(double seconds);
+
+/// get the number of frames presented since winxOpen() was called
+/// only available in the null backend, frames skipped by WINX_HINT_THROTTLE are not counted
+int winxNullGetSwapCount();
+#endif
+
 #define WINX_ICON_DEFAULT NULL
 #define WINX_PRESSED 1
 #define WINX_RELEASED 0
+#define WINX_REPEATED 2
+#define WINX_MOVED 3
+#define WINX_SOURCE_TOUCH 0
+#define WINX_SOURCE_PEN 1
 
 /// hint keys
 #define WINX_HINT_VSYNC         0x01
@@ -203,17 +529,79 @@ double winxGetTime();
 #define WINX_HINT_OPENGL_DEBUG  0x0B
 #define WINX_HINT_OPENGL_ROBUST 0x0C
 #define WINX_HINT_MULTISAMPLES  0x0D
+#define WINX_HINT_CONTEXT       0x0E
+#define WINX_HINT_LAZY          0x0F
+#define WINX_HINT_PERSISTENT    0x10
+#define WINX_HINT_OPENGL_LOADER 0x11
+#define WINX_HINT_THROTTLE      0x12
+#define WINX_HINT_OPENGL_NO_ERROR 0x13
+#define WINX_HINT_OPENGL_RELEASE  0x14
+#define WINX_HINT_SRGB            0x15
+#define WINX_HINT_INPUT_SAMPLES   0x16
 
 /// hint values
 #define WINX_VSYNC_DISABLED 0
 #define WINX_VSYNC_ENABLED 1
 #define WINX_VSYNC_ADAPTIVE -1
+#define WINX_CONTEXT_OPENGL 0
+#define WINX_CONTEXT_SOFTWARE 1
+#define WINX_CONTEXT_NONE 2
+#define WINX_PERSISTENT_NONE 0
+#define WINX_PERSISTENT_DISPLAY 1
+#define WINX_PERSISTENT_WINDOW 2
+#define WINX_LOADER_LAZY 0
+#define WINX_LOADER_BATCH 1
+#define WINX_RELEASE_FLUSH 0
+#define WINX_RELEASE_NONE 1
+
+/// watch events, WINX_WATCH_ERROR is only reported to the handle (also on hang up, read to see the end of file)
+#define WINX_WATCH_READ  0x01
+#define WINX_WATCH_WRITE 0x02
+#define WINX_WATCH_ERROR 0x04
+
+/// native event hook order
+#define WINX_NATIVE_BEFORE 0
+#define WINX_NATIVE_AFTER  1
+
+/// debug message types
+#define WINX_DEBUG_ERROR       0x01
+#define WINX_DEBUG_DEPRECATED  0x02
+#define WINX_DEBUG_UNDEFINED   0x04
+#define WINX_DEBUG_PORTABILITY 0x08
+#define WINX_DEBUG_PERFORMANCE 0x10
+#define WINX_DEBUG_OTHER       0x20
+#define WINX_DEBUG_ALL         0x3F
+
+/// debug message severities
+#define WINX_SEVERITY_NOTIFICATION 0
+#define WINX_SEVERITY_LOW 1
+#define WINX_SEVERITY_MEDIUM 2
+#define WINX_SEVERITY_HIGH 3
+
+/// null backend event types
+#define WINX_NULL_CURSOR     0
+#define WINX_NULL_BUTTON     1
+#define WINX_NULL_KEYBOARD   2
+#define WINX_NULL_SCROLL     3
+#define WINX_NULL_CLOSE      4
+#define WINX_NULL_RESIZE     5
+#define WINX_NULL_FOCUS      6
+#define WINX_NULL_EXPOSE     7
+#define WINX_NULL_MONITOR    8
+#define WINX_NULL_VISIBILITY 9
+
+/// capture formats
+#define WINX_CAPTURE_RAW 0 // top-down RGBA frames
+#define WINX_CAPTURE_Y4M 1 // YUV4MPEG2 with 4:4:4 chroma
 
 #if defined(__unix__) || defined(__linux__)
-#	define WINX_GLX
+#	if !defined(WINX_WAYLAND) && !defined(WINX_NULL)
+#		define WINX_GLX
+#	endif
 
 // BEGIN X11 KEYS
 // based on https://code.woboq.org/kde/include/X11/keysymdef.h.html
+// also used by the Wayland backend, XKB keysyms have the same values
 #	ifndef WINX_NO_KEYS
 #	define WXK_SPACE      0x0020 // XK_Space
 #	define WXK_TAB        0xff09 // XK_Tab
@@ -264,7 +652,9 @@ double winxGetTime();
 #	endif
 
 #elif defined(_WIN32) || defined(_WIN64)
-#	define WINX_WINAPI
+#	if !defined(WINX_NULL)
+#		define WINX_WINAPI
+#	endif
 
 // BEGIN WIN KEYS
 // based on https://docs.microsoft.com/en-us/windows/win32/inputdev/virtual-key-codes
@@ -0,0 +1,542 @@
+
+/*
+ * MIT License
+ *
+ * Copyright (c) 2022 magistermaks
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * WINX C++20 coroutine documentation:
+ *
+ *	This optional header lets C++20 coroutines wait for frames, events and timeouts instead of registering
+ *	event handles. Write the coroutines as functions returning 'winx::task', start them with 'winx::spawn' once
+ *	the window is open, and then call 'winx::run', which drives them from the WINX event loop until all of them
+ *	finished or one of them called 'winx::stop'. Everything runs on the thread that opened the window.
+ *
+ *	winx::task render() {
+ *		while (true) {
+ *			// draw here
+ *
+ *			co_await winx::next_frame(); // swap frame buffers
+ *		}
+ *	}
+ *
+ *	winx::task input() {
+ *		while (true) {
+ *			winx::event event = co_await winx::next_event();
+ *
+ *			if (event.type == winx::event_type::close) {
+ *				winx::stop();
+ *			}
+ *		}
+ *	}
+ *
+ *	winx::spawn(render());
+ *	winx::spawn(input());
+ *	winx::run();
+ *	winxClose();
+ *
+ *	'winx::next_frame' resumes after 'winxSwapBuffers' presented the frame, 'winx::next_event' with each event
+ *	(all coroutines waiting for it get the same event, events that arrive while none waits are dropped),
+ *	'winx::next_event' with a timeout resumes with an empty optional if nothing arrived in time, and 'winx::sleep'
+ *	resumes after the given number of seconds. A coroutine can also 'co_await' another 'winx::task' to run it to completion.
+ *
+ *	'winx::run' replaces all event handles of the window. Waiting never allocates, and the frames of finished
+ *	coroutines are kept for the next coroutines of the same size (up to WINX_FRAME_CACHE of them), so coroutines that
+ *	are started over and over again don't allocate either. Exceptions thrown out of a coroutine terminate the program.
+ */
+
+#ifndef WINX_HPP
+#define WINX_HPP
+
+#include "winx.h"
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include <cstddef>
+#include <new>
+
+#ifndef WINX_FRAME_CACHE
+#	define WINX_FRAME_CACHE 16
+#endif
+
+namespace winx {
+
+	enum class event_type {
+		cursor,
+		button,
+		keyboard,
+		scroll,
+		close,
+		resize,
+		focus,
+		expose,
+		monitor,
+		visibility
+	};
+
+	struct event {
+		event_type type;
+		int state; // for buttons, keys, focus and visibility
+		int code; // button, key, scroll or monitor
+		int x, y; // for cursor and expose events
+		int width, height; // for resize and expose events
+	};
+
+	namespace detail {
+
+		// a suspended coroutine, the nodes live in the awaiters so waiting never allocates
+		struct waiter {
+			std::coroutine_handle<> handle;
+			waiter* next = nullptr;
+			int timer = 0;
+			std::optional<event> result;
+		};
+
+		struct waiter_list {
+			waiter* head = nullptr;
+			waiter** tail = &head;
+
+			void push(waiter* node) {
+				node->next = nullptr;
+				*tail = node;
+				tail = &node->next;
+			}
+
+			waiter* remove(int timer) {
+				for (waiter** it = &head; *it; it = &(*it)->next) {
+					waiter* node = *it;
+
+					if (node->timer == timer) {
+						*it = node->next;
+						tail = node->next ? tail : it;
+						return node;
+					}
+				}
+
+				return nullptr;
+			}
+
+			// detach all nodes, so that coroutines waiting again while being resumed wait for the next time
+			waiter* take() {
+				waiter* list = head;
+				head = nullptr;
+				tail = &head;
+				return list;
+			}
+		};
+
+		struct scheduler {
+			waiter_list frames;
+			waiter_list events;
+			waiter_list sleepers;
+			int alive = 0;
+			bool stopped = false;
+
+			// frames of finished coroutines, with their sizes
+			void* cache[WINX_FRAME_CACHE];
+			std::size_t cache_sizes[WINX_FRAME_CACHE];
+			int cache_count = 0;
+
+			~scheduler() {
+				for (int i = 0; i < cache_count; i ++) {
+					::operator delete(cache[i]);
+				}
+			}
+		};
+
+		inline scheduler& get_scheduler() {
+			static scheduler instance;
+			return instance;
+		}
+
+		inline void* allocate_frame(std::size_t size) {
+			scheduler& state = get_scheduler();
+
+			for (int i = 0; i < state.cache_count; i ++) {
+				if (state.cache_sizes[i] == size) {
+					void* frame = state.cache[i];
+					state.cache_count --;
+					state.cache[i] = state.cache[state.cache_count];
+					state.cache_sizes[i] = state.cache_sizes[state.cache_count];
+					return frame;
+				}
+			}
+
+			return ::operator new(size);
+		}
+
+		inline void free_frame(void* frame, std::size_t size) {
+			scheduler& state = get_scheduler();
+
+			if (state.cache_count == WINX_FRAME_CACHE) {
+				::operator delete(frame);
+				return;
+			}
+
+			state.cache[state.cache_count] = frame;
+			state.cache_sizes[state.cache_count] = size;
+			state.cache_count ++;
+		}
+
+		inline void resume(waiter* list) {
+			while (list) {
+				// the node is gone once its coroutine resumes
+				waiter* next = list->next;
+				list->handle.resume();
+				list = next;
+			}
+		}
+
+		inline void dispatch(const event& value) {
+			waiter* list = get_scheduler().events.take();
+
+			for (waiter* node = list; node; node = node->next) {
+				if (node->timer) {
+					winxRemoveTimer(node->timer);
+					node->timer = 0;
+				}
+
+				node->result = value;
+			}
+
+			resume(list);
+		}
+
+		inline void on_timer(int timer) {
+			scheduler& state = get_scheduler();
+			winxRemoveTimer(timer);
+
+			// the timer is either a timeout of an event wait or a sleep
+			waiter* node = state.events.remove(timer);
+			node = node ? node : state.sleepers.remove(timer);
+
+			if (node) {
+				node->timer = 0;
+				node->handle.resume();
+			}
+		}
+
+		inline void on_cursor(int x, int y) {
+			dispatch({event_type::cursor, 0, 0, x, y, 0, 0});
+		}
+
+		inline void on_button(int state, int button) {
+			dispatch({event_type::button, state, button, 0, 0, 0, 0});
+		}
+
+		inline void on_keyboard(int state, int keycode) {
+			dispatch({event_type::keyboard, state, keycode, 0, 0, 0, 0});
+		}
+
+		inline void on_scroll(int scroll) {
+			dispatch({event_type::scroll, 0, scroll, 0, 0, 0, 0});
+		}
+
+		inline void on_close() {
+			dispatch({event_type::close, 0, 0, 0, 0, 0, 0});
+		}
+
+		inline void on_resize(int width, int height) {
+			dispatch({event_type::resize, 0, 0, 0, 0, width, height});
+		}
+
+		inline void on_focus(bool focused) {
+			dispatch({event_type::focus, focused, 0, 0, 0, 0, 0});
+		}
+
+		inline void on_expose(int x, int y, int width, int height) {
+			dispatch({event_type::expose, 0, 0, x, y, width, height});
+		}
+
+		inline void on_monitor(int monitor) {
+			dispatch({event_type::monitor, 0, monitor, 0, 0, 0, 0});
+		}
+
+		inline void on_visibility(bool visible) {
+			dispatch({event_type::visibility, visible, 0, 0, 0, 0, 0});
+		}
+
+	}
+
+	class task {
+		public:
+			struct promise_type;
+
+			struct final_awaiter {
+				bool await_ready() noexcept {
+					return false;
+				}
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+					promise_type& promise = handle.promise();
+
+					// nobody owns spawned coroutines, so they clean up after themselves
+					if (promise.detached) {
+						detail::get_scheduler().alive --;
+						handle.destroy();
+						return std::noop_coroutine();
+					}
+
+					return promise.continuation ? promise.continuation : std::noop_coroutine();
+				}
+
+				void await_resume() noexcept {}
+			};
+
+			struct promise_type {
+				std::coroutine_handle<> continuation;
+				bool detached = false;
+
+				task get_return_object() noexcept {
+					return task {std::coroutine_handle<promise_type>::from_promise(*this)};
+				}
+
+				std::suspend_always initial_suspend() noexcept {
+					return {};
+				}
+
+				final_awaiter final_suspend() noexcept {
+					return {};
+				}
+
+				void return_void() noexcept {}
+
+				void unhandled_exception() noexcept {
+					std::terminate();
+				}
+
+				static void* operator new(std::size_t size) {
+					return detail::allocate_frame(size);
+				}
+
+				static void operator delete(void* frame, std::size_t size) {
+					detail::free_frame(frame, size);
+				}
+			};
+
+			struct awaiter {
+				std::coroutine_handle<promise_type> handle;
+
+				bool await_ready() noexcept {
+					return !handle || handle.done();
+				}
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+					handle.promise().continuation = continuation;
+					return handle;
+				}
+
+				void await_resume() noexcept {}
+			};
+
+			task(task&& other) noexcept
+			: handle(other.handle) {
+				other.handle = nullptr;
+			}
+
+			task(const task&) = delete;
+			task& operator=(const task&) = delete;
+
+			~task() {
+				if (handle) {
+					handle.destroy();
+				}
+			}
+
+			/// run this task to completion, the awaiting coroutine resumes when it finishes
+			awaiter operator co_await() && noexcept {
+				return awaiter {handle};
+			}
+
+			/// give up the ownership of the coroutine, used by winx::spawn()
+			std::coroutine_handle<promise_type> release() noexcept {
+				std::coroutine_handle<promise_type> released = handle;
+				handle = nullptr;
+				return released;
+			}
+
+		private:
+			explicit task(std::coroutine_handle<promise_type> handle) noexcept
+			: handle(handle) {}
+
+			std::coroutine_handle<promise_type> handle;
+	};
+
+	struct frame_awaiter {
+		detail::waiter node;
+
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) noexcept {
+			node.handle = handle;
+			detail::get_scheduler().frames.push(&node);
+		}
+
+		void await_resume() noexcept {}
+	};
+
+	struct event_awaiter {
+		detail::waiter node;
+
+		bool await_ready() noexcept {
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> handle) noexcept {
+			node.handle = handle;
+			detail::get_scheduler().events.push(&node);
+		}
+
+		event await_resume() noexcept {
+			return *node.result;
+		}
+	};
+
+	struct timed_event_awaiter {
+		detail::waiter node;
+		double timeout;
+
+		bool await_ready() noexcept {
+			return timeout <= 0;
+		}
+
+		bool await_suspend(std::coroutine_handle<> handle) noexcept {
+			node.handle = handle;
+			node.timer = winxAddTimer(timeout, detail::on_timer);
+
+			// without a timer it would wait forever, so give up right away
+			if (!node.timer) {
+				return false;
+			}
+
+			detail::get_scheduler().events.push(&node);
+			return true;
+		}
+
+		std::optional<event> await_resume() noexcept {
+			return node.result;
+		}
+	};
+
+	struct sleep_awaiter {
+		detail::waiter node;
+		double seconds;
+
+		bool await_ready() noexcept {
+			return seconds <= 0;
+		}
+
+		bool await_suspend(std::coroutine_handle<> handle) noexcept {
+			node.handle = handle;
+			node.timer = winxAddTimer(seconds, detail::on_timer);
+
+			if (!node.timer) {
+				return false;
+			}
+
+			detail::get_scheduler().sleepers.push(&node);
+			return true;
+		}
+
+		void await_resume() noexcept {}
+	};
+
+	/// resume after the next winxSwapBuffers() presented the frame drawn so far
+	/// all coroutines waiting for it share the same swap, in lazy mode it waits for winxGetRedraw()
+	inline frame_awaiter next_frame() {
+		return {};
+	}
+
+	/// resume with the next window event
+	/// all coroutines waiting for it get the same event
+	inline event_awaiter next_event() {
+		return {};
+	}
+
+	/// resume with the next window event, or an empty optional after the given number of seconds
+	/// all coroutines waiting for it get the same event
+	inline timed_event_awaiter next_event(double timeout) {
+		return {{}, timeout};
+	}
+
+	/// resume after the given number of seconds
+	/// uses winxAddTimer(), so it can't resume earlier than the event loop wakes up for the timer
+	inline sleep_awaiter sleep(double seconds) {
+		return {{}, seconds};
+	}
+
+	/// start a coroutine, it runs until its first co_await right away and then from winx::run()
+	/// the scheduler owns it from now on and destroys it once it finishes
+	inline void spawn(task&& coroutine) {
+		std::coroutine_handle<task::promise_type> handle = coroutine.release();
+
+		if (handle) {
+			handle.promise().detached = true;
+			detail::get_scheduler().alive ++;
+			handle.resume();
+		}
+	}
+
+	/// make winx::run() return once the current event or frame is handled
+	/// the remaining coroutines stay suspended, and continue with the next winx::run()
+	inline void stop() {
+		detail::get_scheduler().stopped = true;
+	}
+
+	/// drive the spawned coroutines from the event loop of the current window until they finish or winx::stop() is called
+	/// replaces all event handles, the window has to stay open until it returns
+	inline void run() {
+		detail::scheduler& state = detail::get_scheduler();
+		state.stopped = false;
+
+		winxSetCursorEventHandle(detail::on_cursor);
+		winxSetButtonEventHandle(detail::on_button);
+		winxSetKeyboardEventHandle(detail::on_keyboard);
+		winxSetScrollEventHandle(detail::on_scroll);
+		winxSetCloseEventHandle(detail::on_close);
+		winxSetResizeEventHandle(detail::on_resize);
+		winxSetFocusEventHandle(detail::on_focus);
+		winxSetExposeEventHandle(detail::on_expose);
+		winxSetMonitorEventHandle(detail::on_monitor);
+		winxSetVisibilityEventHandle(detail::on_visibility);
+
+		while (!state.stopped && state.alive > 0) {
+
+			// only block when nobody waits for the next frame
+			if (state.frames.head) {
+				winxPollEvents();
+			} else {
+				winxWaitEvents();
+			}
+
+			if (!state.stopped && state.frames.head) {
+				winxSwapBuffers();
+				detail::resume(state.frames.take());
+			}
+		}
+	}
+
+}
+
+#endif // WINX_HPP